@@ -58,7 +58,71 @@ private:
     return v - n;
   }
 
+  static constexpr size_type S_batch_ratio = 256;
+
+  static size_type S_depth(size_type v) { return 63 - __builtin_clzll(v); }
+
+  template <typename Tp, typename Chunks, typename Fn>
+  void M_batch(std::vector<std::pair<size_type, Tp>> const& xs, Chunks chunks, Fn fn) {
+    // Applies fn(leaf, x) for each (i, x) of xs in order, marking the
+    // parents of the leaves in a bitmap of the internal nodes, and then
+    // recomputes the marked nodes a depth at a time from the deepest,
+    // marking their parents in turn, so that each is recomputed once.
+    // The leaves and the nodes of each depth go through chunks(lo, hi,
+    // fn), which may run the chunks at once (see whole_chunk).  Small
+    // batches go one by one instead, as the bitmap costs n/64 words to
+    // scan.
+    size_type n = M_base_size;
+    auto fix = [&](size_type v) { M_c[v] = M_op1(M_c[v<<1|0], M_c[v<<1|1]); };
+    if (xs.size() * S_batch_ratio < n) {
+      for (auto const& [i, x]: xs) {
+        size_type v = i + n;
+        fn(M_c[v], x);
+        while (v > 1) fix(v >>= 1);
+      }
+      return;
+    }
+
+    std::vector<uint64_t> dirty(n / 64 + 1);
+    auto mark = [&](size_type v) { dirty[v >> 6] |= uint64_t(1) << (v & 63); };
+    chunks(n, n+n, [&](size_type lo, size_type hi) {
+      for (auto const& [i, x]: xs) {
+        size_type v = i + n;
+        if (v < lo || hi <= v) continue;
+        fn(M_c[v], x);
+        mark(v >> 1);
+      }
+    });
+    if (n < 2) return;
+
+    for (size_type d = S_depth(n-1) + 1; d--;) {
+      size_type lo = size_type(1) << d;
+      size_type hi = std::min(lo << 1, n);
+      chunks(lo, hi, [&](size_type a, size_type b) {
+        for (size_type w = a >> 6; w <= (b-1) >> 6; ++w) {
+          uint64_t bits = dirty[w];
+          if (w == a >> 6) bits &= ~uint64_t(0) << (a & 63);
+          if (w == (b-1) >> 6 && b % 64 != 0) bits &= (uint64_t(1) << (b & 63)) - 1;
+          for (; bits; bits &= bits-1) {
+            size_type v = w << 6 | __builtin_ctzll(bits);
+            fix(v);
+            mark(v >> 1);
+          }
+        }
+      });
+    }
+  }
+
 public:
+  struct whole_chunk {
+    // Runs fn(lo, hi) at once.  The batch operations take others, such
+    // as parallel_chunks in utility/parallel_chunks.cpp, which call fn on
+    // consecutive chunks of [lo, hi) concurrently, provided that the
+    // bounds between them are multiples of 128.
+    template <typename Fn>
+    void operator ()(size_type lo, size_type hi, Fn fn) const { fn(lo, hi); }
+  };
+
   basic_segment_tree() = default;
   basic_segment_tree(basic_segment_tree const&) = default;
   basic_segment_tree(basic_segment_tree&&) = default;
@@ -115,9 +179,24 @@ public:
     }
   }
 
+  template <typename Chunks = whole_chunk>
+  void modify_batch(std::vector<std::pair<size_type, second_type>> const& xs,
+                    Chunks chunks = Chunks()) {
+    // modify(i, x) for each (i, x) of xs, in order for the same i, with
+    // each node above them recomputed once rather than once per update
+    M_batch(xs, chunks, [&](value_type& y, second_type const& x) { y = M_op2(y, x); });
+  }
+
+  template <typename Chunks = whole_chunk>
+  void assign_at_batch(std::vector<std::pair<size_type, value_type>> const& xs,
+                       Chunks chunks = Chunks()) {
+    // assign_at(i, x) for each (i, x) of xs, likewise
+    M_batch(xs, chunks, [](value_type& y, value_type const& x) { y = x; });
+  }
+
   value_type const& operator [](size_type i) const { return M_c[i + M_base_size]; }
 
-  value_type accumulate(size_type l, size_type r) {
+  value_type accumulate(size_type l, size_type r) const {
     first_type resl = M_op1.identity;
     first_type resr = resl;
     l += M_base_size;
@@ -131,6 +210,17 @@ public:
     return M_op1(resl, resr);
   }
 
+  template <typename Chunks = whole_chunk>
+  std::vector<value_type> accumulate_batch(std::vector<std::pair<size_type, size_type>> const& rs,
+                                           Chunks chunks = Chunks()) const {
+    // accumulate(l, r) for each (l, r) of rs
+    std::vector<value_type> res(rs.size());
+    chunks(0, rs.size(), [&](size_type lo, size_type hi) {
+      for (size_type j = lo; j < hi; ++j) res[j] = accumulate(rs[j].first, rs[j].second);
+    });
+    return res;
+  }
+
   template <typename Predicate>
   std::pair<size_type, value_type> partition_point(Predicate pred) const {
     value_type value;
@@ -0,0 +1,477 @@
+class dynamic_bit_vector {
+  // A B+-tree over the bits.  A leaf is one cache line of S_bits bits,
+  // and an inner node keeps, for up to S_fanout children, the numbers of
+  // bits and of ones up to each of them, so that a query reads a few
+  // lines per level.  Updates split the full children and fix the thin
+  // ones on the way down, so that they never go back up but to subtract
+  // an erased one.  Nodes are taken from pools and referred to by 32-bit
+  // indices, and the counts are 32-bit as well, so that the size is
+  // limited to below 2^32.
+  static constexpr size_t S_words = 8;
+  static constexpr size_t S_bits = 64 * S_words;
+  static constexpr size_t S_fanout = 15;
+  static constexpr size_t S_thin_leaf = S_bits / 4;
+  static constexpr size_t S_thin_inner = 4;
+  static constexpr size_t S_depth = 32;
+
+  struct alignas(64) leaf {
+    uint64_t bits[S_words] = {};  // zero from the size up
+  };
+  struct alignas(64) inner {
+    // bits and ones in the children up to each (inclusive), padded to a
+    // line apiece
+    uint32_t size[S_fanout+1] = {};
+    uint32_t ones[S_fanout+1] = {};
+    uint32_t child[S_fanout] = {};
+    uint32_t num = 0;
+  };
+  struct entry {
+    uint32_t size, ones, child;
+  };
+
+  template <class Node>
+  class pool {
+    std::vector<Node> M_nodes;
+    std::vector<uint32_t> M_free;
+
+  public:
+    uint32_t get() {
+      // may move the nodes, so that no reference should be held across
+      if (M_free.empty()) {
+        M_nodes.emplace_back();
+        return M_nodes.size() - 1;
+      }
+      uint32_t i = M_free.back();
+      M_free.pop_back();
+      M_nodes[i] = Node();
+      return i;
+    }
+    void put(uint32_t i) { M_free.push_back(i); }
+    void reserve(size_t n) { M_nodes.reserve(n); }
+    Node& operator [](uint32_t i) { return M_nodes[i]; }
+    Node const& operator [](uint32_t i) const { return M_nodes[i]; }
+  };
+
+  pool<leaf> M_leaf;
+  pool<inner> M_inner;
+  uint32_t M_root;
+  size_t M_height = 1;  // of the inner nodes; leaves are below them
+
+  static size_t S_select_word(uint64_t x, size_t k) {
+    // the position of the k-th (0-indexed) one in x
+#ifdef __BMI2__
+    return __builtin_ctzll(__builtin_ia32_pdep_di(uint64_t(1) << k, x));
+#else
+    for (; k > 0; --k) x &= x-1;
+    return __builtin_ctzll(x);
+#endif
+  }
+
+  static uint64_t S_get(uint64_t const* w, size_t pos) {
+    // 64 bits from pos; w has a word of padding
+    size_t sh = pos % 64;
+    uint64_t x = w[pos / 64] >> sh;
+    if (sh) x |= w[pos / 64 + 1] << (64 - sh);
+    return x;
+  }
+
+  static uint64_t S_mask(size_t k) {
+    return (k >= 64)? -1: (uint64_t(1) << k) - 1;
+  }
+
+  static void S_insert(uint64_t* w, size_t used, size_t pos, bool x) {
+    size_t k = pos / 64;
+    uint64_t mask = S_mask(pos % 64);
+    uint64_t carry = w[k] >> 63;
+    w[k] = (w[k] & ~mask) << 1 | (w[k] & mask) | uint64_t(x) << (pos % 64);
+    for (++k; k <= used / 64; ++k) {
+      uint64_t tmp = w[k] >> 63;
+      w[k] = w[k] << 1 | carry;
+      carry = tmp;
+    }
+  }
+
+  static bool S_erase(uint64_t* w, size_t used, size_t pos) {
+    size_t k = pos / 64;
+    bool res = w[k] >> (pos % 64) & 1;
+    uint64_t mask = S_mask(pos % 64);
+    w[k] = (w[k] >> 1 & ~mask) | (w[k] & mask);
+    for (++k; k < (used + 63) / 64; ++k) {
+      w[k-1] |= w[k] << 63;
+      w[k] >>= 1;
+    }
+    return res;
+  }
+
+  static size_t S_rank(uint64_t const* w, size_t pos) {
+    size_t res = 0;
+    for (size_t k = 0; k < pos / 64; ++k) res += __builtin_popcountll(w[k]);
+    if (pos % 64) res += __builtin_popcountll(w[pos / 64] & S_mask(pos % 64));
+    return res;
+  }
+
+  template <int Bp>
+  static size_t S_select(uint64_t const* w, size_t k) {
+    // the position of the k-th (0-indexed) Bp, which is there
+    for (size_t i = 0; true; ++i) {
+      uint64_t x = Bp? w[i]: ~w[i];
+      size_t c = __builtin_popcountll(x);
+      if (k < c) return 64 * i + S_select_word(x, k);
+      k -= c;
+    }
+  }
+
+  static size_t S_unpack(inner const& x, entry* e) {
+    for (size_t j = 0; j < x.num; ++j) {
+      e[j].size = x.size[j] - (j? x.size[j-1]: 0);
+      e[j].ones = x.ones[j] - (j? x.ones[j-1]: 0);
+      e[j].child = x.child[j];
+    }
+    return x.num;
+  }
+
+  static void S_pack(inner& x, entry const* e, size_t num) {
+    uint32_t size = 0, ones = 0;
+    for (size_t j = 0; j < num; ++j) {
+      x.size[j] = (size += e[j].size);
+      x.ones[j] = (ones += e[j].ones);
+      x.child[j] = e[j].child;
+    }
+    x.num = num;
+  }
+
+  static entry S_whole(inner const& x, uint32_t i) {
+    return {x.size[x.num-1], x.ones[x.num-1], i};
+  }
+
+  bool M_merge_leaves(entry& ea, entry& eb) {
+    // moves the bits of b to a if they fit, or halves them otherwise
+    uint64_t buf[2*S_words+1] = {};
+    leaf& a = M_leaf[ea.child];
+    leaf& b = M_leaf[eb.child];
+    std::copy(a.bits, a.bits + S_words, buf);
+    for (size_t k = 0; 64*k < eb.size; ++k) {
+      size_t pos = ea.size + 64*k;
+      buf[pos / 64] |= b.bits[k] << (pos % 64);
+      if (pos % 64) buf[pos / 64 + 1] |= b.bits[k] >> (64 - pos % 64);
+    }
+    size_t total = ea.size + eb.size;
+    uint32_t ones = ea.ones + eb.ones;
+    if (total <= S_bits) {
+      std::copy(buf, buf + S_words, a.bits);
+      ea.size = total;
+      ea.ones = ones;
+      M_leaf.put(eb.child);
+      return true;
+    }
+
+    size_t half = total / 2;
+    ea.ones = 0;
+    for (size_t k = 0; k < S_words; ++k) {
+      a.bits[k] = (64*k < half)? buf[k] & S_mask(half - 64*k): 0;
+      ea.ones += __builtin_popcountll(a.bits[k]);
+    }
+    for (size_t k = 0; k < S_words; ++k)
+      b.bits[k] = (64*k < total-half)? S_get(buf, half + 64*k) & S_mask(total-half - 64*k): 0;
+    ea.size = half;
+    eb.size = total - half;
+    eb.ones = ones - ea.ones;
+    return false;
+  }
+
+  bool M_merge_inners(entry& ea, entry& eb) {
+    entry buf[2*S_fanout];
+    inner& a = M_inner[ea.child];
+    inner& b = M_inner[eb.child];
+    size_t na = S_unpack(a, buf);
+    size_t total = na + S_unpack(b, buf + na);
+    if (total <= S_fanout) {
+      S_pack(a, buf, total);
+      ea = S_whole(a, ea.child);
+      M_inner.put(eb.child);
+      return true;
+    }
+
+    S_pack(a, buf, total / 2);
+    S_pack(b, buf + total / 2, total - total / 2);
+    ea = S_whole(a, ea.child);
+    eb = S_whole(b, eb.child);
+    return false;
+  }
+
+  void M_split(uint32_t cur, size_t i, bool is_leaf) {
+    // splits the full i-th child of cur, which has room for one more
+    uint32_t fresh = is_leaf? M_leaf.get(): M_inner.get();
+    entry e[S_fanout+1];
+    size_t num = S_unpack(M_inner[cur], e);
+    std::copy_backward(e + i + 1, e + num, e + num + 1);
+    entry& ea = e[i];
+    entry& eb = e[i+1];
+    eb.child = fresh;
+    if (is_leaf) {
+      leaf& a = M_leaf[ea.child];
+      leaf& b = M_leaf[fresh];
+      std::copy(a.bits + S_words/2, a.bits + S_words, b.bits);
+      std::fill(a.bits + S_words/2, a.bits + S_words, 0);
+      ea.size = eb.size = S_bits / 2;
+      eb.ones = S_rank(b.bits, S_bits / 2);
+      ea.ones -= eb.ones;
+    } else {
+      entry buf[S_fanout];
+      S_unpack(M_inner[ea.child], buf);
+      S_pack(M_inner[ea.child], buf, S_fanout / 2 + 1);
+      S_pack(M_inner[fresh], buf + S_fanout / 2 + 1, S_fanout / 2);
+      ea = S_whole(M_inner[ea.child], ea.child);
+      eb = S_whole(M_inner[fresh], fresh);
+    }
+    S_pack(M_inner[cur], e, num+1);
+  }
+
+  void M_fix(uint32_t cur, size_t i, bool is_leaf) {
+    // merges the thin i-th child of cur with its neighbor, or evens them
+    entry e[S_fanout];
+    size_t num = S_unpack(M_inner[cur], e);
+    size_t j = (i+1 < num)? i: i-1;
+    bool merged = is_leaf? M_merge_leaves(e[j], e[j+1]): M_merge_inners(e[j], e[j+1]);
+    if (merged) {
+      std::copy(e + j + 2, e + num, e + j + 1);
+      --num;
+    }
+    S_pack(M_inner[cur], e, num);
+  }
+
+  bool M_thin(inner const& p, size_t i, bool is_leaf) const {
+    if (is_leaf) return p.size[i] - (i? p.size[i-1]: 0) <= S_thin_leaf;
+    return M_inner[p.child[i]].num <= S_thin_inner;
+  }
+
+  void M_build(std::vector<uint64_t> const& words, size_t n) {
+    // bottom-up, with nodes three quarters full
+    size_t const fill_words = S_words * 3 / 4;
+    size_t const fill_fanout = S_fanout * 3 / 4;
+    std::vector<entry> level;
+    M_leaf.reserve(n / (64 * fill_words) + 1);
+    for (size_t k = 0; k == 0 || 64*k < n; k += fill_words) {
+      uint32_t i = M_leaf.get();
+      leaf& x = M_leaf[i];
+      entry e{0, 0, i};
+      for (size_t l = 0; l < fill_words && 64*(k+l) < n; ++l) {
+        x.bits[l] = words[k+l] & S_mask(n - 64*(k+l));
+        e.size += std::min<size_t>(64, n - 64*(k+l));
+        e.ones += __builtin_popcountll(x.bits[l]);
+      }
+      level.push_back(e);
+    }
+
+    M_height = 0;
+    do {
+      size_t groups = (level.size() + fill_fanout - 1) / fill_fanout;
+      std::vector<entry> next(groups);
+      for (size_t g = 0, k = 0; g < groups; ++g) {
+        size_t num = (level.size() - k) / (groups - g);
+        uint32_t i = M_inner.get();
+        S_pack(M_inner[i], level.data() + k, num);
+        next[g] = S_whole(M_inner[i], i);
+        k += num;
+      }
+      level.swap(next);
+      ++M_height;
+    } while (level.size() > 1);
+    M_root = level[0].child;
+  }
+
+  void M_collect(uint32_t cur, size_t d, std::vector<uint64_t>& res, size_t& len) const {
+    inner const& p = M_inner[cur];
+    for (size_t j = 0; j < p.num; ++j) {
+      if (d < M_height) {
+        M_collect(p.child[j], d+1, res, len);
+        continue;
+      }
+      uint64_t const* w = M_leaf[p.child[j]].bits;
+      size_t used = p.size[j] - (j? p.size[j-1]: 0);
+      for (size_t k = 0; 64*k < used; ++k) {
+        res[len / 64] |= w[k] << (len % 64);
+        if (len % 64) res[len / 64 + 1] |= w[k] >> (64 - len % 64);
+        len += std::min<size_t>(64, used - 64*k);
+      }
+    }
+  }
+
+  template <int Bp>
+  size_t M_select(size_t k) const {
+    if (k == 0) return 0;
+    if (k > (Bp? ones(): size() - ones())) return -1;
+    size_t res = 0;
+    uint32_t cur = M_root;
+    for (size_t d = 1; true; ++d) {
+      inner const& p = M_inner[cur];
+      size_t i = 0;
+      for (size_t j = 0; j+1 < p.num; ++j)
+        i += ((Bp? p.ones[j]: p.size[j] - p.ones[j]) < k);
+      if (i > 0) {
+        res += p.size[i-1];
+        k -= Bp? p.ones[i-1]: p.size[i-1] - p.ones[i-1];
+      }
+      if (d == M_height) return res + S_select<Bp>(M_leaf[p.child[i]].bits, k-1) + 1;
+      cur = p.child[i];
+    }
+  }
+
+public:
+  dynamic_bit_vector(): dynamic_bit_vector(std::vector<uint64_t>(), 0) {}
+
+  dynamic_bit_vector(const std::vector<bool>& b) {
+    std::vector<uint64_t> words((b.size() + 63) / 64);
+    for (size_t i = 0; i < b.size(); ++i)
+      if (b[i]) words[i / 64] |= uint64_t(1) << (i % 64);
+    M_build(words, b.size());
+  }
+
+  dynamic_bit_vector(std::vector<uint64_t> const& words, size_t n) {
+    // the first n bits of the words, in O(n/64)
+    M_build(words, n);
+  }
+
+  size_t size() const { return M_inner[M_root].size[M_inner[M_root].num-1]; }
+  bool empty() const { return size() == 0; }
+  size_t ones() const { return M_inner[M_root].ones[M_inner[M_root].num-1]; }
+
+  std::vector<uint64_t> words() const {
+    // the bits packed into words, with one word of padding, in O(n/64)
+    std::vector<uint64_t> res(size() / 64 + 2);
+    size_t len = 0;
+    M_collect(M_root, 1, res, len);
+    return res;
+  }
+
+  size_t rank1(size_t t) const {
+    size_t res = 0;
+    uint32_t cur = M_root;
+    for (size_t d = 1; true; ++d) {
+      inner const& p = M_inner[cur];
+      size_t i = 0;
+      for (size_t j = 0; j+1 < p.num; ++j) i += (p.size[j] <= t);
+      if (i > 0) {
+        t -= p.size[i-1];
+        res += p.ones[i-1];
+      }
+      if (d == M_height) return res + S_rank(M_leaf[p.child[i]].bits, t);
+      cur = p.child[i];
+    }
+  }
+
+  size_t rank0(size_t t) const { return t - rank1(t); }
+
+  size_t select1(size_t k) const {
+    // the smallest i such that rank1(i) == k, or -1 if none
+    return M_select<1>(k);
+  }
+
+  size_t select0(size_t k) const { return M_select<0>(k); }
+
+  size_t rank(int x, size_t t) const { return x? rank1(t): rank0(t); }
+  size_t select(int x, size_t k) const { return x? select1(k): select0(k); }
+
+  bool operator [](size_t t) const {
+    uint32_t cur = M_root;
+    for (size_t d = 1; true; ++d) {
+      inner const& p = M_inner[cur];
+      size_t i = 0;
+      for (size_t j = 0; j+1 < p.num; ++j) i += (p.size[j] <= t);
+      if (i > 0) t -= p.size[i-1];
+      if (d == M_height) return M_leaf[p.child[i]].bits[t / 64] >> (t % 64) & 1;
+      cur = p.child[i];
+    }
+  }
+
+  void insert(size_t t, int x) {
+    if (M_inner[M_root].num == S_fanout) {
+      uint32_t root = M_inner.get();
+      entry e = S_whole(M_inner[M_root], M_root);
+      S_pack(M_inner[root], &e, 1);
+      M_root = root;
+      ++M_height;
+    }
+
+    uint32_t cur = M_root;
+    for (size_t d = 1; true; ++d) {
+      // cur has room for one more child
+      auto find = [&] {
+        inner const& p = M_inner[cur];
+        size_t i = 0;
+        for (size_t j = 0; j+1 < p.num; ++j) i += (p.size[j] < t);
+        return i;
+      };
+      size_t i = find();
+      bool is_leaf = (d == M_height);
+      bool full = is_leaf? (M_inner[cur].size[i] - (i? M_inner[cur].size[i-1]: 0) == S_bits):
+        (M_inner[M_inner[cur].child[i]].num == S_fanout);
+      if (full) {
+        M_split(cur, i, is_leaf);
+        i = find();
+      }
+
+      inner& p = M_inner[cur];
+      size_t used = p.size[i];
+      if (i > 0) {
+        t -= p.size[i-1];
+        used -= p.size[i-1];
+      }
+      for (size_t j = i; j < p.num; ++j) {
+        ++p.size[j];
+        p.ones[j] += !!x;
+      }
+      if (is_leaf) return S_insert(M_leaf[p.child[i]].bits, used, t, x);
+      cur = p.child[i];
+    }
+  }
+
+  void erase(size_t t) {
+    while (M_height > 1 && M_inner[M_root].num == 1) {
+      uint32_t child = M_inner[M_root].child[0];
+      M_inner.put(M_root);
+      M_root = child;
+      --M_height;
+    }
+
+    uint32_t path[S_depth];
+    size_t slot[S_depth];
+    uint32_t cur = M_root;
+    for (size_t d = 1; true; ++d) {
+      auto find = [&] {
+        inner const& p = M_inner[cur];
+        size_t i = 0;
+        for (size_t j = 0; j+1 < p.num; ++j) i += (p.size[j] <= t);
+        return i;
+      };
+      size_t i = find();
+      bool is_leaf = (d == M_height);
+      if (M_inner[cur].num > 1 && M_thin(M_inner[cur], i, is_leaf)) {
+        M_fix(cur, i, is_leaf);
+        i = find();
+      }
+
+      inner& p = M_inner[cur];
+      size_t used = p.size[i];
+      if (i > 0) {
+        t -= p.size[i-1];
+        used -= p.size[i-1];
+      }
+      for (size_t j = i; j < p.num; ++j) --p.size[j];
+      path[d-1] = cur;
+      slot[d-1] = i;
+      if (!is_leaf) {
+        cur = p.child[i];
+        continue;
+      }
+
+      if (S_erase(M_leaf[p.child[i]].bits, used, t)) {
+        for (size_t e = 0; e < d; ++e) {
+          inner& q = M_inner[path[e]];
+          for (size_t j = slot[e]; j < q.num; ++j) --q.ones[j];
+        }
+      }
+      return;
+    }
+  }
+};
@@ -0,0 +1,349 @@
+template <typename Monoid>
+class dynamic_segment_tree {
+  // segment_tree over [0, n) for n up to 2^63, with nodes allocated only
+  // where updates touch, so that the keys need not be compressed
+  // beforehand.  Each node is an aligned interval [a, a+2^h) of the
+  // perfect binary tree over [0, 2^M_log), and a child slot of a node,
+  // one of its halves, holds either nothing or a node somewhere within,
+  // the rest of the slot being the initial values.  Chains of one child
+  // are thus skipped, and a point update adds at most a leaf and the
+  // node where its path branches off.  The fold of 2^h initial values is
+  // M_fill[h], from which those of the slots around a node are made.
+  //
+  // As in segment_tree, a node holds its value with its own deferred
+  // operation applied, and the operations are pushed down on the way of
+  // updates, which fills both slots of a node with nodes of their full
+  // size.  Folds and searches leave the tree as it is, and apply the
+  // deferred operations of the ancestors on the way back up instead.
+  // Nodes are taken from an arena and referred to by 32-bit indices, 0
+  // meaning none, so that there are below 2^32 of them.
+public:
+  using size_type = size_t;
+  using first_type = typename Monoid::first_type;
+  using second_type = typename Monoid::second_type;
+  using value_type = first_type;
+  using binary_operation = typename Monoid::binary_operation;
+  using external_binary_operation = typename Monoid::external_binary_operation;
+  using merge_operation = typename Monoid::merge_operation;
+
+private:
+  struct node {
+    value_type value;
+    second_type deferred;
+    uint64_t code = 0;  // 2a + 2^h for [a, a+2^h)
+    uint32_t child[2] = {0, 0};
+  };
+
+  using arena = node_arena<node>;
+
+  size_type M_base_size = 0;
+  size_type M_log = 0;
+  binary_operation M_op1;
+  external_binary_operation M_op2;
+  merge_operation M_op3;
+  arena M_pool;
+  std::vector<value_type> M_fill;
+  uint32_t M_root = 0;
+
+  static size_type S_bitlen(size_type x) { return x? 64 - __builtin_clzll(x): 0; }
+
+  size_type M_height(uint32_t v) const { return __builtin_ctzll(M_pool[v].code); }
+  size_type M_lo(uint32_t v) const {
+    return (M_pool[v].code - (size_type(1) << M_height(v))) >> 1;
+  }
+  size_type M_hi(uint32_t v) const { return M_lo(v) + (size_type(1) << M_height(v)); }
+
+  uint32_t M_new(size_type a, size_type h, value_type const& x) {
+    return M_pool.push(node{x, M_op3.identity, 2*a + (size_type(1) << h)});
+  }
+
+  value_type M_pow(size_type k) const {
+    // the fold of k > 0 initial values, in any order as they are equal
+    value_type x = M_fill[__builtin_ctzll(k)];
+    for (k &= k-1; k > 0; k &= k-1) x = M_op1(x, M_fill[__builtin_ctzll(k)]);
+    return x;
+  }
+
+  value_type M_slot_value(uint32_t c, size_type g) const {
+    // the fold of a slot of height g holding c
+    if (c == 0) return M_fill[g];
+    value_type x = M_pool[c].value;
+    size_type a = M_lo(c);
+    for (size_type i = M_height(c); i < g; ++i)
+      x = (a >> i & 1)? M_op1(M_fill[i], x): M_op1(x, M_fill[i]);
+    return x;
+  }
+
+  uint32_t M_wrap(uint32_t c, size_type g, size_type s) {
+    // a node of the whole slot [s, s+2^g), holding c
+    if (c != 0 && M_height(c) == g) return c;
+    uint32_t v = M_new(s, g, M_slot_value(c, g));
+    if (c != 0) M_pool[v].child[M_lo(c) >> (g-1) & 1] = c;
+    return v;
+  }
+
+  void M_apply(uint32_t v, second_type const& x) {
+    M_pool[v].value = M_op2(M_pool[v].value, x);
+    if (M_height(v) > 0) M_pool[v].deferred = M_op3(M_pool[v].deferred, x);
+  }
+
+  void M_push(uint32_t v) {
+    if (M_pool[v].deferred == M_op3.identity) return;
+    size_type h = M_height(v);
+    size_type a = M_lo(v);
+    for (size_type j = 0; j < 2; ++j) {
+      uint32_t c = M_wrap(M_pool[v].child[j], h-1, a + (j << (h-1)));
+      M_pool[v].child[j] = c;
+      M_apply(c, M_pool[v].deferred);
+    }
+    M_pool[v].deferred = M_op3.identity;
+  }
+
+  uint32_t M_modify_slot(uint32_t c, size_type g, size_type s, size_type l, size_type r,
+                         second_type const& x) {
+    // on the slot [s, s+2^g) holding c, which meets [l, r); returns the
+    // node to hold instead, the least one over both c and [l, r)
+    size_type lo = std::max(l, s);
+    size_type hi = std::min(r, s + (size_type(1) << g));
+    size_type h = S_bitlen(lo ^ (hi-1));
+    if (c != 0) h = std::max({h, M_height(c), S_bitlen(lo ^ M_lo(c))});
+    uint32_t v = M_wrap(c, h, lo >> h << h);
+    M_modify_node(v, l, r, x);
+    return v;
+  }
+
+  void M_modify_node(uint32_t v, size_type l, size_type r, second_type const& x) {
+    size_type a = M_lo(v);
+    size_type h = M_height(v);
+    if (l <= a && a + (size_type(1) << h) <= r) {
+      M_apply(v, x);
+      return;
+    }
+    M_push(v);
+    size_type m = a + (size_type(1) << (h-1));
+    if (l < m) {
+      uint32_t c = M_modify_slot(M_pool[v].child[0], h-1, a, l, r, x);
+      M_pool[v].child[0] = c;
+    }
+    if (m < r) {
+      uint32_t c = M_modify_slot(M_pool[v].child[1], h-1, m, l, r, x);
+      M_pool[v].child[1] = c;
+    }
+    M_pool[v].value = M_op1(M_slot_value(M_pool[v].child[0], h-1),
+                            M_slot_value(M_pool[v].child[1], h-1));
+  }
+
+  value_type M_accumulate_slot(uint32_t c, size_type g, size_type s, size_type l, size_type r) const {
+    // the fold of [s, s+2^g) and [l, r), which meet, with the initial
+    // values around c; the identity is not folded in, as it may not be
+    // one for the external operation
+    size_type lo = std::max(l, s);
+    size_type hi = std::min(r, s + (size_type(1) << g));
+    if (c == 0) return M_pow(hi - lo);
+    size_type a = M_lo(c);
+    size_type b = M_hi(c);
+    if (hi <= a) return M_pow(hi - lo);
+    if (b <= lo) return M_pow(hi - lo);
+    value_type x = M_accumulate_node(c, l, r);
+    if (lo < a) x = M_op1(M_pow(a - lo), x);
+    if (b < hi) x = M_op1(x, M_pow(hi - b));
+    return x;
+  }
+
+  value_type M_accumulate_node(uint32_t v, size_type l, size_type r) const {
+    // likewise for the node v
+    size_type a = M_lo(v);
+    size_type h = M_height(v);
+    if (l <= a && a + (size_type(1) << h) <= r) return M_pool[v].value;
+    size_type m = a + (size_type(1) << (h-1));
+    uint32_t c0 = M_pool[v].child[0];
+    uint32_t c1 = M_pool[v].child[1];
+    value_type x = (r <= m)? M_accumulate_slot(c0, h-1, a, l, r):
+                   (m <= l)? M_accumulate_slot(c1, h-1, m, l, r):
+                   M_op1(M_accumulate_slot(c0, h-1, a, l, r), M_accumulate_slot(c1, h-1, m, l, r));
+    return M_op2(x, M_pool[v].deferred);
+  }
+
+  template <typename Predicate>
+  bool M_max_right_fill(size_type lo, size_type hi, Predicate& pred, second_type const& d,
+                        value_type& x, size_type& res) const {
+    // folds the initial values of [lo, hi) into x while pred holds, d
+    // being the deferred operations of the ancestors; false if it stops,
+    // at res.  As the values are equal, the powers of two are tried from
+    // the largest.
+    if (lo >= hi) return true;
+    size_type k = hi - lo;
+    value_type y = M_op1(x, M_op2(M_pow(k), d));
+    if (pred(y)) {
+      x = y;
+      return true;
+    }
+    size_type t = 0;
+    for (size_type i = S_bitlen(k); i--;) {
+      if (t + (size_type(1) << i) > k) continue;
+      y = M_op1(x, M_op2(M_fill[i], d));
+      if (!pred(y)) continue;
+      x = y;
+      t += size_type(1) << i;
+    }
+    res = lo + t;
+    return false;
+  }
+
+  template <typename Predicate>
+  bool M_max_right_slot(uint32_t c, size_type g, size_type s, size_type l, Predicate& pred,
+                        second_type const& d, value_type& x, size_type& res) const {
+    // likewise [max(s, l), s+2^g), holding c
+    size_type lo = std::max(l, s);
+    size_type hi = s + (size_type(1) << g);
+    if (hi <= lo) return true;
+    if (c == 0) return M_max_right_fill(lo, hi, pred, d, x, res);
+    size_type a = M_lo(c);
+    size_type b = M_hi(c);
+    return (M_max_right_fill(lo, std::min(a, hi), pred, d, x, res) &&
+            M_max_right_node(c, l, pred, d, x, res) &&
+            M_max_right_fill(std::max(lo, b), hi, pred, d, x, res));
+  }
+
+  template <typename Predicate>
+  bool M_max_right_node(uint32_t v, size_type l, Predicate& pred, second_type const& d,
+                        value_type& x, size_type& res) const {
+    size_type a = M_lo(v);
+    size_type h = M_height(v);
+    if (a + (size_type(1) << h) <= l) return true;
+    if (l <= a) {
+      value_type y = M_op1(x, M_op2(M_pool[v].value, d));
+      if (pred(y)) {
+        x = y;
+        return true;
+      }
+      if (h == 0) {
+        res = a;
+        return false;
+      }
+    }
+    second_type e = M_op3(M_pool[v].deferred, d);
+    size_type m = a + (size_type(1) << (h-1));
+    return (M_max_right_slot(M_pool[v].child[0], h-1, a, l, pred, e, x, res) &&
+            M_max_right_slot(M_pool[v].child[1], h-1, m, l, pred, e, x, res));
+  }
+
+  template <typename Predicate>
+  bool M_min_left_fill(size_type lo, size_type hi, Predicate& pred, second_type const& d,
+                       value_type& x, size_type& res) const {
+    // as M_max_right_fill(), from the right; res is past the stop
+    if (lo >= hi) return true;
+    size_type k = hi - lo;
+    value_type y = M_op1(M_op2(M_pow(k), d), x);
+    if (pred(y)) {
+      x = y;
+      return true;
+    }
+    size_type t = 0;
+    for (size_type i = S_bitlen(k); i--;) {
+      if (t + (size_type(1) << i) > k) continue;
+      y = M_op1(M_op2(M_fill[i], d), x);
+      if (!pred(y)) continue;
+      x = y;
+      t += size_type(1) << i;
+    }
+    res = hi - t;
+    return false;
+  }
+
+  template <typename Predicate>
+  bool M_min_left_slot(uint32_t c, size_type g, size_type s, size_type r, Predicate& pred,
+                       second_type const& d, value_type& x, size_type& res) const {
+    // likewise [s, min(s+2^g, r)), holding c
+    size_type lo = s;
+    size_type hi = std::min(r, s + (size_type(1) << g));
+    if (hi <= lo) return true;
+    if (c == 0) return M_min_left_fill(lo, hi, pred, d, x, res);
+    size_type a = M_lo(c);
+    size_type b = M_hi(c);
+    return (M_min_left_fill(std::max(lo, b), hi, pred, d, x, res) &&
+            M_min_left_node(c, r, pred, d, x, res) &&
+            M_min_left_fill(lo, std::min(a, hi), pred, d, x, res));
+  }
+
+  template <typename Predicate>
+  bool M_min_left_node(uint32_t v, size_type r, Predicate& pred, second_type const& d,
+                       value_type& x, size_type& res) const {
+    size_type a = M_lo(v);
+    size_type h = M_height(v);
+    size_type b = a + (size_type(1) << h);
+    if (r <= a) return true;
+    if (b <= r) {
+      value_type y = M_op1(M_op2(M_pool[v].value, d), x);
+      if (pred(y)) {
+        x = y;
+        return true;
+      }
+      if (h == 0) {
+        res = b;
+        return false;
+      }
+    }
+    second_type e = M_op3(M_pool[v].deferred, d);
+    size_type m = a + (size_type(1) << (h-1));
+    return (M_min_left_slot(M_pool[v].child[1], h-1, m, r, pred, e, x, res) &&
+            M_min_left_slot(M_pool[v].child[0], h-1, a, r, pred, e, x, res));
+  }
+
+public:
+  dynamic_segment_tree(): dynamic_segment_tree(0) {}
+  dynamic_segment_tree(dynamic_segment_tree const&) = default;
+  dynamic_segment_tree(dynamic_segment_tree&&) = default;
+
+  dynamic_segment_tree(size_type n, first_type const& x = binary_operation().identity):
+    M_base_size(n)
+  {
+    M_pool.push(node());  // for none
+    while ((size_type(1) << M_log) < n) ++M_log;
+    M_fill.assign(1, x);
+    for (size_type h = 0; h < M_log; ++h) M_fill.push_back(M_op1(M_fill[h], M_fill[h]));
+  }
+
+  dynamic_segment_tree& operator =(dynamic_segment_tree const&) = default;
+  dynamic_segment_tree& operator =(dynamic_segment_tree&&) = default;
+
+  size_type size() const { return M_base_size; }
+  size_type nodes() const { return M_pool.size() - 1; }
+  size_type memory() const {
+    // the bytes allocated for the nodes
+    return M_pool.capacity() * sizeof(node);
+  }
+
+  void modify(size_type l, size_type r, second_type const& x) {
+    if (l >= r) return;
+    M_root = M_modify_slot(M_root, M_log, 0, l, r, x);
+  }
+
+  first_type accumulate(size_type l, size_type r) const {
+    if (l >= r) return M_op1.identity;
+    return M_accumulate_slot(M_root, M_log, 0, l, r);
+  }
+
+  first_type operator [](size_type i) const { return accumulate(i, i+1); }
+
+  template <typename Predicate>
+  size_type max_right(size_type l, Predicate pred) const {
+    // the largest r such that pred(accumulate(l, r)), for pred monotone
+    // with pred(identity)
+    if (l >= M_base_size) return M_base_size;
+    value_type x = M_op1.identity;
+    size_type res = M_base_size;
+    M_max_right_slot(M_root, M_log, 0, l, pred, M_op3.identity, x, res);
+    return std::min(res, M_base_size);
+  }
+
+  template <typename Predicate>
+  size_type min_left(size_type r, Predicate pred) const {
+    // the smallest l such that pred(accumulate(l, r)), likewise
+    if (r == 0) return 0;
+    value_type x = M_op1.identity;
+    size_type res = 0;
+    M_min_left_slot(M_root, M_log, 0, r, pred, M_op3.identity, x, res);
+    return res;
+  }
+};
@@ -0,0 +1,31 @@
+template <typename Node>
+class node_arena {
+  // Nodes in chunks of S_chunk, which never move, so that growing takes
+  // neither copies nor twice the memory as a vector would.  They are
+  // referred to by 32-bit indices, in the order pushed.
+  static constexpr size_t S_chunk = size_t(1) << 16;
+  std::vector<std::unique_ptr<Node[]>> M_chunks;
+  size_t M_size = 0;
+
+public:
+  node_arena() = default;
+  node_arena(node_arena&&) = default;
+  node_arena(node_arena const& other): M_size(other.M_size) {
+    for (auto const& c: other.M_chunks) {
+      M_chunks.emplace_back(new Node[S_chunk]);
+      std::copy(c.get(), c.get() + S_chunk, M_chunks.back().get());
+    }
+  }
+  node_arena& operator =(node_arena&&) = default;
+  node_arena& operator =(node_arena const& other) { return *this = node_arena(other); }
+
+  uint32_t push(Node const& x) {
+    if (M_size % S_chunk == 0) M_chunks.emplace_back(new Node[S_chunk]);
+    M_chunks.back()[M_size % S_chunk] = x;
+    return M_size++;
+  }
+  size_t size() const { return M_size; }
+  size_t capacity() const { return M_chunks.size() * S_chunk; }
+  Node& operator [](uint32_t i) { return M_chunks[i / S_chunk][i % S_chunk]; }
+  Node const& operator [](uint32_t i) const { return M_chunks[i / S_chunk][i % S_chunk]; }
+};
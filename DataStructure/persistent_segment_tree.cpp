@@ -0,0 +1,218 @@
+template <typename Monoid>
+class persistent_segment_tree {
+  // basic_segment_tree with every version kept: an update copies the
+  // path to the leaf, ceil(log2(n))+1 nodes, into a new version sharing
+  // the rest, and the versions are numbered from 0, the initial one.
+  // A node over [a, b) has children over [a, m) and [m, b) for the
+  // midpoint m, and the nodes are referred to by 32-bit indices into an
+  // arena that is only appended to, so that there are below 2^32 of
+  // them.  Released versions are reclaimed by collect(), which copies
+  // the nodes still reachable into a new arena, in depth-first order.
+public:
+  using size_type = size_t;
+  using first_type = typename Monoid::first_type;
+  using second_type = typename Monoid::second_type;
+  using value_type = first_type;
+  using binary_operation = typename Monoid::binary_operation;
+  using external_binary_operation = typename Monoid::external_binary_operation;
+
+private:
+  struct node {
+    value_type value;
+    uint32_t child[2] = {0, 0};
+  };
+
+  using arena = node_arena<node>;
+
+  static constexpr uint32_t S_released = -1;
+
+  size_type M_base_size = 0;
+  binary_operation M_op1;
+  external_binary_operation M_op2;
+  arena M_pool;
+  std::vector<uint32_t> M_roots;
+
+  uint32_t M_new(value_type const& x, uint32_t c0 = 0, uint32_t c1 = 0) {
+    return M_pool.push(node{x, {c0, c1}});
+  }
+
+  uint32_t M_join(uint32_t c0, uint32_t c1) {
+    return M_new(M_op1(M_pool[c0].value, M_pool[c1].value), c0, c1);
+  }
+
+  template <typename InputIt>
+  uint32_t M_build(InputIt& it, size_type n) {
+    // of the next n values, from the left
+    if (n == 1) return M_new(*it++);
+    uint32_t c0 = M_build(it, n/2);
+    uint32_t c1 = M_build(it, n - n/2);
+    return M_join(c0, c1);
+  }
+
+  uint32_t M_fill(size_type n, value_type const& x, std::vector<std::pair<size_type, uint32_t>>& memo) {
+    // of n values x, sharing the subtrees of the same length, of which
+    // there are at most two on each level
+    for (auto const& [len, v]: memo)
+      if (len == n) return v;
+    uint32_t v = (n == 1)? M_new(x): M_join(M_fill(n/2, x, memo), M_fill(n - n/2, x, memo));
+    memo.emplace_back(n, v);
+    return v;
+  }
+
+  template <typename Fn>
+  uint32_t M_update(uint32_t v, size_type a, size_type b, size_type i, Fn fn) {
+    // the copy of the path from v to the leaf i, with fn applied there
+    if (b - a == 1) return M_new(fn(M_pool[v].value));
+    size_type m = a + (b-a) / 2;
+    uint32_t c0 = M_pool[v].child[0];
+    uint32_t c1 = M_pool[v].child[1];
+    if (i < m) {
+      c0 = M_update(c0, a, m, i, fn);
+    } else {
+      c1 = M_update(c1, m, b, i, fn);
+    }
+    return M_join(c0, c1);
+  }
+
+  value_type M_accumulate(uint32_t v, size_type a, size_type b, size_type l, size_type r) const {
+    // the fold of [a, b) and [l, r), which meet
+    if (l <= a && b <= r) return M_pool[v].value;
+    size_type m = a + (b-a) / 2;
+    if (r <= m) return M_accumulate(M_pool[v].child[0], a, m, l, r);
+    if (m <= l) return M_accumulate(M_pool[v].child[1], m, b, l, r);
+    return M_op1(M_accumulate(M_pool[v].child[0], a, m, l, r),
+                 M_accumulate(M_pool[v].child[1], m, b, l, r));
+  }
+
+  uint32_t M_copy(uint32_t v, size_type n, arena& pool, std::vector<uint32_t>& moved) const {
+    // v into pool, unless it is there already
+    if (moved[v] != S_released) return moved[v];
+    uint32_t w = pool.push(M_pool[v]);
+    moved[v] = w;
+    if (n > 1) {
+      uint32_t c0 = M_copy(M_pool[v].child[0], n/2, pool, moved);
+      uint32_t c1 = M_copy(M_pool[v].child[1], n - n/2, pool, moved);
+      pool[w].child[0] = c0;
+      pool[w].child[1] = c1;
+    }
+    return w;
+  }
+
+public:
+  persistent_segment_tree(): persistent_segment_tree(0) {}
+  persistent_segment_tree(persistent_segment_tree const&) = default;
+  persistent_segment_tree(persistent_segment_tree&&) = default;
+
+  persistent_segment_tree(size_type n, first_type const& x = binary_operation().identity):
+    M_base_size(n)
+  {
+    M_pool.push(node());  // for the empty tree
+    std::vector<std::pair<size_type, uint32_t>> memo;
+    M_roots.push_back((n > 0)? M_fill(n, x, memo): 0);
+  }
+
+  template <typename InputIt>
+  persistent_segment_tree(InputIt first, InputIt last):
+    M_base_size(std::distance(first, last))
+  {
+    M_pool.push(node());
+    M_roots.push_back((M_base_size > 0)? M_build(first, M_base_size): 0);
+  }
+
+  persistent_segment_tree& operator =(persistent_segment_tree const&) = default;
+  persistent_segment_tree& operator =(persistent_segment_tree&&) = default;
+
+  size_type size() const { return M_base_size; }
+  size_type versions() const { return M_roots.size(); }
+  size_type nodes() const { return M_pool.size() - 1; }
+  size_type memory() const {
+    // the bytes allocated for the nodes and the roots
+    return M_pool.capacity() * sizeof(node) + M_roots.capacity() * sizeof(uint32_t);
+  }
+
+  size_type modify(size_type t, size_type i, second_type const& x) {
+    // a new version, of the version t with modify(i, x); returns its number
+    uint32_t v = M_update(M_roots[t], 0, M_base_size, i,
+                          [&](value_type const& y) { return M_op2(y, x); });
+    M_roots.push_back(v);
+    return M_roots.size() - 1;
+  }
+
+  size_type assign_at(size_type t, size_type i, value_type const& x) {
+    // likewise with assign_at(i, x)
+    uint32_t v = M_update(M_roots[t], 0, M_base_size, i, [&](value_type const&) { return x; });
+    M_roots.push_back(v);
+    return M_roots.size() - 1;
+  }
+
+  value_type accumulate(size_type t, size_type l, size_type r) const {
+    // the fold of [l, r) as of the version t
+    if (l >= r) return M_op1.identity;
+    return M_accumulate(M_roots[t], 0, M_base_size, l, r);
+  }
+
+  value_type const& get(size_type t, size_type i) const {
+    uint32_t v = M_roots[t];
+    size_type a = 0;
+    size_type b = M_base_size;
+    while (b - a > 1) {
+      size_type m = a + (b-a) / 2;
+      if (i < m) {
+        v = M_pool[v].child[0];
+        b = m;
+      } else {
+        v = M_pool[v].child[1];
+        a = m;
+      }
+    }
+    return M_pool[v].value;
+  }
+
+  size_type quantile(value_type k, size_type s, size_type t) const {
+    // For counts, with value_type arithmetic: the k-th (0-indexed)
+    // smallest index in the multiset of the counts of the version t less
+    // those of the version s, descending both at once; size() if there
+    // are no more than k.  With the versions from counting the values of
+    // an array one by one, this is the k-th smallest value of a range.
+    uint32_t u = M_roots[s];
+    uint32_t v = M_roots[t];
+    if (M_base_size == 0 || !(k < M_pool[v].value - M_pool[u].value)) return M_base_size;
+    size_type a = 0;
+    size_type b = M_base_size;
+    while (b - a > 1) {
+      size_type m = a + (b-a) / 2;
+      uint32_t u0 = M_pool[u].child[0];
+      uint32_t v0 = M_pool[v].child[0];
+      value_type left = M_pool[v0].value - M_pool[u0].value;
+      if (k < left) {
+        u = u0;
+        v = v0;
+        b = m;
+      } else {
+        k -= left;
+        u = M_pool[u].child[1];
+        v = M_pool[v].child[1];
+        a = m;
+      }
+    }
+    return a;
+  }
+
+  void release(size_type t) {
+    // the version t is no longer needed; its nodes not shared with other
+    // versions are reclaimed by the next collect()
+    M_roots[t] = S_released;
+  }
+
+  void collect() {
+    // copies the nodes of the versions not released into a new arena,
+    // each shared node once, and frees the old one
+    arena pool;
+    pool.push(node());
+    std::vector<uint32_t> moved(M_pool.size(), S_released);
+    moved[0] = 0;
+    for (auto& root: M_roots)
+      if (root != S_released) root = M_copy(root, M_base_size, pool, moved);
+    M_pool = std::move(pool);
+  }
+};
@@ -0,0 +1,246 @@
+class rrr_vector {
+  // A compressed bit vector with the interface of bit_vector in
+  // wavelet_matrix.cpp.  Blocks of 63 bits are stored as their number of
+  // ones (the class, in 6 bits) and their index among the blocks of the
+  // class (the offset, in ceil(log2 C(63, class)) bits), as Raman, Raman
+  // and Rao do, so that the space is close to the zero-order entropy of
+  // each block.  Blocks of classes whose offsets would take S_plain bits
+  // or more are stored as they are instead, as those are slow to decode
+  // and hardly compressible.  Every S_super blocks, the ones before and
+  // the position in the offsets are kept; a query walks the classes from
+  // there and decodes one block, only down to the bit in question for
+  // rank.
+  static constexpr size_t S_block = 63;
+  static constexpr size_t S_class = 6;
+  static constexpr size_t S_super = 32;
+  static constexpr size_t S_plain = 56;
+
+  struct binomial_table {
+    uint64_t c[64][64] = {};
+    size_t len[64] = {};
+    binomial_table() {
+      for (size_t i = 0; i < 64; ++i) {
+        c[i][0] = 1;
+        for (size_t j = 1; j <= i; ++j) c[i][j] = c[i-1][j-1] + c[i-1][j];
+      }
+      for (size_t j = 0; j <= S_block; ++j) {
+        len[j] = (c[S_block][j] > 1)? 64 - __builtin_clzll(c[S_block][j] - 1): 0;
+        if (len[j] >= S_plain) len[j] = S_block;
+      }
+    }
+  };
+
+  size_t M_n = 0;
+  size_t M_ones = 0;
+  std::vector<uint64_t> M_raw;  // the words until build()
+  std::vector<uint64_t> M_class, M_offset;  // packed
+  std::vector<size_t> M_rank, M_pos;  // per superblock, with a sentinel
+
+  static binomial_table const& S_table() {
+    static binomial_table const table;
+    return table;
+  }
+
+  static uint64_t S_get(std::vector<uint64_t> const& v, size_t pos, size_t len) {
+    // len (<= 64) bits from pos; v has a word of padding
+    if (len == 0) return 0;
+    size_t sh = pos % 64;
+    uint64_t x = v[pos / 64] >> sh;
+    if (sh + len > 64) x |= v[pos / 64 + 1] << (64 - sh);
+    return (len == 64)? x: x & ((uint64_t(1) << len) - 1);
+  }
+
+  static void S_put(std::vector<uint64_t>& v, size_t pos, size_t len, uint64_t x) {
+    if (len == 0) return;
+    size_t sh = pos % 64;
+    v[pos / 64] |= x << sh;
+    if (sh + len > 64) v[pos / 64 + 1] |= x >> (64 - sh);
+  }
+
+  static uint64_t S_encode(uint64_t w, size_t c) {
+    // the index of w among the blocks with c ones, in lexicographic order
+    auto const& tb = S_table();
+    if (tb.len[c] == S_block) return w;
+    uint64_t off = 0;
+    for (size_t i = S_block; c > 0 && i-- > 0;) {
+      if (w >> i & 1) {
+        off += tb.c[i][c];
+        --c;
+      }
+    }
+    return off;
+  }
+
+  static uint64_t S_decode(size_t c, uint64_t off, size_t low = 0) {
+    // the bits from low up of the block, with no branch to mispredict
+    auto const& tb = S_table();
+    if (tb.len[c] == S_block) return off >> low << low;
+    uint64_t w = 0;
+    for (size_t i = S_block; c > 0 && i-- > low;) {
+      uint64_t bit = (off >= tb.c[i][c]);
+      w |= bit << i;
+      off -= tb.c[i][c] & -bit;
+      c -= bit;
+    }
+    return w;
+  }
+
+  static size_t S_select_word(uint64_t x, size_t k) {
+    // the position of the k-th (0-indexed) one in x
+#ifdef __BMI2__
+    return __builtin_ctzll(__builtin_ia32_pdep_di(uint64_t(1) << k, x));
+#else
+    for (; k > 0; --k) x &= x-1;
+    return __builtin_ctzll(x);
+#endif
+  }
+
+  size_t M_blocks() const { return (M_n + S_block - 1) / S_block; }
+  size_t M_class_of(size_t b) const { return S_get(M_class, S_class * b, S_class); }
+
+  template <int Bp>
+  size_t M_select(size_t k) const {
+    if (k == 0) return 0;
+    if (k > (Bp? M_ones: M_n - M_ones)) return -1;
+    auto before = [&](size_t sb) {
+      return Bp? M_rank[sb]: sb * S_super * S_block - M_rank[sb];
+    };
+
+    // the last superblock with less than k before it
+    size_t lb = 0;
+    size_t ub = M_rank.size() - 1;
+    while (ub - lb > 1) {
+      size_t mid = (lb+ub) >> 1;
+      ((before(mid) < k)? lb: ub) = mid;
+    }
+
+    size_t r = k - before(lb);
+    size_t pos = M_pos[lb];
+    size_t b = lb * S_super;
+    auto const& tb = S_table();
+    while (true) {
+      size_t c = M_class_of(b);
+      size_t num = (Bp? c: S_block - c);
+      if (r <= num) {
+        uint64_t w = S_decode(c, S_get(M_offset, pos, tb.len[c]));
+        if (!Bp) w = ~w;
+        return b * S_block + S_select_word(w, r-1) + 1;
+      }
+      r -= num;
+      pos += tb.len[c];
+      ++b;
+    }
+  }
+
+  uint64_t M_block(size_t b, size_t low, size_t& ones_before) const {
+    // the bits from low up of the b-th block, with the ones before the
+    // bit low
+    auto const& tb = S_table();
+    size_t sb = b / S_super;
+    ones_before = M_rank[sb];
+    size_t pos = M_pos[sb];
+    for (size_t i = sb * S_super; i < b; ++i) {
+      size_t c = M_class_of(i);
+      ones_before += c;
+      pos += tb.len[c];
+    }
+    if (b == M_blocks()) return 0;
+    size_t c = M_class_of(b);
+    uint64_t w = S_decode(c, S_get(M_offset, pos, tb.len[c]), low);
+    ones_before += c - __builtin_popcountll(w);
+    return w;
+  }
+
+public:
+  rrr_vector() {}
+
+  rrr_vector(const std::vector<bool>& b): rrr_vector(b.size()) {
+    for (size_t i = 0; i < M_n; ++i)
+      if (b[i]) M_raw[i / 64] |= uint64_t(1) << (i % 64);
+    build();
+  }
+
+  explicit rrr_vector(size_t n): M_n(n), M_raw(n / 64 + 2) {
+    // n zeros, to be filled by set_word() and made queryable by build()
+  }
+
+  void set_word(size_t i, uint64_t x) {
+    M_raw[i] = x;
+  }
+
+  void build() {
+    // encodes the words, which are freed then
+    auto const& tb = S_table();
+    size_t nb = M_blocks();
+    size_t nsb = nb / S_super + 1;
+    M_class.assign(S_class * nb / 64 + 2, 0);
+    M_rank.assign(nsb + 1, 0);
+    M_pos.assign(nsb + 1, 0);
+
+    size_t total = 0;
+    for (size_t b = 0; b < nb; ++b)
+      total += tb.len[__builtin_popcountll(S_get(M_raw, S_block * b, S_block))];
+    M_offset.assign(total / 64 + 2, 0);
+
+    size_t ones = 0;
+    size_t pos = 0;
+    for (size_t b = 0; b < nb; ++b) {
+      if (b % S_super == 0) {
+        M_rank[b / S_super] = ones;
+        M_pos[b / S_super] = pos;
+      }
+      uint64_t w = S_get(M_raw, S_block * b, S_block);
+      size_t c = __builtin_popcountll(w);
+      S_put(M_class, S_class * b, S_class, c);
+      S_put(M_offset, pos, tb.len[c], S_encode(w, c));
+      ones += c;
+      pos += tb.len[c];
+    }
+    for (size_t sb = (nb + S_super - 1) / S_super; sb <= nsb; ++sb) {
+      M_rank[sb] = ones;
+      M_pos[sb] = pos;
+    }
+    M_ones = ones;
+    std::vector<uint64_t>().swap(M_raw);
+  }
+
+  size_t size() const { return M_n; }
+
+  size_t rank1(size_t k) const {
+    size_t ones;
+    M_block(k / S_block, k % S_block, ones);
+    return ones;
+  }
+
+  size_t rank0(size_t k) const {
+    return k - rank1(k);
+  }
+
+  size_t select1(size_t k) const {
+    // the smallest i such that rank1(i) == k, or -1 if none
+    return M_select<1>(k);
+  }
+
+  size_t select0(size_t k) const {
+    return M_select<0>(k);
+  }
+
+  size_t rank(int x, size_t k) const {
+    return x? rank1(k) : rank0(k);
+  }
+
+  size_t select(int x, size_t k) const {
+    return x? select1(k) : select0(k);
+  }
+
+  bool operator [](size_t k) const {
+    size_t ones;
+    return M_block(k / S_block, k % S_block, ones) >> (k % S_block) & 1;
+  }
+
+  void prefetch(size_t k) const {
+    size_t b = k / S_block;
+    __builtin_prefetch(&M_pos[b / S_super]);
+    __builtin_prefetch(&M_class[S_class * b / 64]);
+  }
+};
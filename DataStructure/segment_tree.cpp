@@ -15,35 +15,54 @@ public:
   using sub_container = SubContainer;
 
 private:
-  size_t M_base_size;
+  // The leaves are at [M_size, M_size+M_base_size) for the power of two
+  // M_size, so that the ancestors of a boundary are found by shifts.  A
+  // node holds its value with its own deferred operation applied, and
+  // the operations deferred at the ancestors of the boundaries are
+  // pushed down before any access, top-down, so that they are applied
+  // in the right order even if they do not commute.
+  size_t M_base_size = 0;
+  size_t M_size = 1;
+  size_t M_log = 0;
   binary_operation M_op1;
   external_binary_operation M_op2;
   merge_operation M_op3;
   container M_c;
   sub_container M_d;  // deferred
 
-  void M_build(size_t i) {
-    while (i > 1) {
-      i >>= 1;
-      M_c[i] = M_op2(M_op1(M_c[i<<1|0], M_c[i<<1|1]), M_d[i]);
+  void M_update(size_t i) {
+    M_c[i] = M_op1(M_c[i<<1|0], M_c[i<<1|1]);
+  }
+
+  void M_apply(size_t i, second_type const& x) {
+    M_c[i] = M_op2(M_c[i], x);
+    if (i < M_size) M_d[i] = M_op3(M_d[i], x);
+  }
+
+  void M_push(size_t i) {
+    if (M_d[i] != M_op3.identity) {
+      M_apply(i<<1|0, M_d[i]);
+      M_apply(i<<1|1, M_d[i]);
+      M_d[i] = M_op3.identity;
     }
   }
 
-  void M_resolve(size_t i) {
-    size_t h = (sizeof(long long) * CHAR_BIT) - __builtin_clzll(M_base_size*2);
-    for (size_t s = h; s > 0; --s) {
-      size_t p = i >> s;
-      if (M_d[p] != M_op3.identity) {
-        M_apply(p<<1|0, M_d[p]);
-        M_apply(p<<1|1, M_d[p]);
-        M_d[p] = M_op3.identity;
-      }
+  void M_resolve(size_t l, size_t r) {
+    // pushes down to the leaves l and r-1, skipping the ancestors that
+    // have the whole [l, r) on one side
+    for (size_t s = M_log; s > 0; --s) {
+      if (((l >> s) << s) != l) M_push(l >> s);
+      if (((r >> s) << s) != r) M_push((r-1) >> s);
     }
   }
 
-  void M_apply(size_t i, second_type const& x) {
-    M_c[i] = M_op2(M_c[i], x);
-    if (i < M_base_size) M_d[i] = M_op3(M_d[i], x);
+  void M_init(size_t n) {
+    M_base_size = n;
+    M_log = 0;
+    while ((size_t(1) << M_log) < n) ++M_log;
+    M_size = size_t(1) << M_log;
+    M_c.assign(M_size+M_size, M_op1.identity);
+    M_d.assign(M_size, M_op3.identity);
   }
 
 public:
@@ -51,59 +70,55 @@ public:
   segment_tree(segment_tree const&) = default;
   segment_tree(segment_tree&&) = default;
 
-  segment_tree(size_t n, first_type const& x = binary_operation().identity):
-    M_base_size(n),
-    M_op1(binary_operation()),
-    M_op2(external_binary_operation()),
-    M_op3(merge_operation()),
-    M_c(n+n, x), M_d(n, M_op3.identity)
-  {
-    for (size_t i = n; i--;)
-      M_c[i] = M_op1(M_c[i<<1|0], M_c[i<<1|1]);
+  segment_tree(size_t n, first_type const& x = binary_operation().identity) {
+    M_init(n);
+    std::fill(M_c.begin()+M_size, M_c.begin()+M_size+n, x);
+    for (size_t i = M_size; i-- > 1;) M_update(i);
   }
 
   template <typename InputIt>
-  segment_tree(InputIt first, InputIt last):
-    M_base_size(std::distance(first, last)),
-    M_op1(binary_operation()),
-    M_op2(external_binary_operation()),
-    M_op3(merge_operation()),
-    M_c(M_base_size*2), M_d(M_base_size, M_op3.identity)
-  {
-    for (size_t i = M_base_size; first != last; ++i)
-      M_c[i] = *first++;
-    for (size_t i = M_base_size; i--;)
-      M_c[i] = M_op1(M_c[i<<1|0], M_c[i<<1|1]);
+  segment_tree(InputIt first, InputIt last) {
+    M_init(std::distance(first, last));
+    std::copy(first, last, M_c.begin()+M_size);
+    for (size_t i = M_size; i-- > 1;) M_update(i);
   }
 
   segment_tree& operator =(segment_tree const&) = default;
   segment_tree& operator =(segment_tree&&) = default;
 
+  size_t size() const { return M_base_size; }
+
   void modify(size_t l, size_t r, second_type const& x) {
-    if (l == r) return;  // for [n, n)
-    l += M_base_size;
-    r += M_base_size;
-    size_t l0 = l;
-    size_t r0 = r;
-    while (l < r) {
-      if (l & 1) M_apply(l++, x);
-      if (r & 1) M_apply(--r, x);
-      l >>= 1;
-      r >>= 1;
+    if (l == r) return;
+    l += M_size;
+    r += M_size;
+    M_resolve(l, r);
+    {
+      size_t l0 = l;
+      size_t r0 = r;
+      while (l < r) {
+        if (l & 1) M_apply(l++, x);
+        if (r & 1) M_apply(--r, x);
+        l >>= 1;
+        r >>= 1;
+      }
+      l = l0;
+      r = r0;
+    }
+    for (size_t s = 1; s <= M_log; ++s) {
+      if (((l >> s) << s) != l) M_update(l >> s);
+      if (((r >> s) << s) != r) M_update((r-1) >> s);
     }
-    M_build(l0);
-    M_build(r0-1);
   }
 
   first_type accumulate(size_t l, size_t r) {
     first_type resl = M_op1.identity;
     first_type resr = resl;
-    if (l == r) return resl;  // for [n, n)
+    if (l == r) return resl;
 
-    l += M_base_size;
-    r += M_base_size;
-    M_resolve(l);
-    M_resolve(r-1);
+    l += M_size;
+    r += M_size;
+    M_resolve(l, r);
     while (l < r) {
       if (l & 1) resl = M_op1(resl, M_c[l++]);
       if (r & 1) resr = M_op1(M_c[--r], resr);
@@ -114,10 +129,56 @@ public:
   }
 
   first_type operator [](size_t i) {
-    i += M_base_size;
-    M_resolve(i);
+    i += M_size;
+    for (size_t s = M_log; s > 0; --s) M_push(i >> s);
     return M_c[i];
   }
+
+  template <typename Predicate>
+  size_t max_right(size_t l, Predicate pred) {
+    // the largest r such that pred(accumulate(l, r)), for pred monotone
+    // with pred(identity)
+    if (l == M_base_size) return M_base_size;
+    l += M_size;
+    for (size_t s = M_log; s > 0; --s) M_push(l >> s);
+    first_type x = M_op1.identity;
+    do {
+      while (!(l & 1)) l >>= 1;
+      if (!pred(M_op1(x, M_c[l]))) {
+        while (l < M_size) {
+          M_push(l);
+          l <<= 1;
+          if (pred(M_op1(x, M_c[l]))) x = M_op1(x, M_c[l++]);
+        }
+        return l - M_size;
+      }
+      x = M_op1(x, M_c[l++]);
+    } while ((l & -l) != l);
+    return M_base_size;
+  }
+
+  template <typename Predicate>
+  size_t min_left(size_t r, Predicate pred) {
+    // the smallest l such that pred(accumulate(l, r)), likewise
+    if (r == 0) return 0;
+    r += M_size;
+    for (size_t s = M_log; s > 0; --s) M_push((r-1) >> s);
+    first_type x = M_op1.identity;
+    do {
+      --r;
+      while (r > 1 && (r & 1)) r >>= 1;
+      if (!pred(M_op1(M_c[r], x))) {
+        while (r < M_size) {
+          M_push(r);
+          r = r << 1 | 1;
+          if (pred(M_op1(M_c[r], x))) x = M_op1(M_c[r--], x);
+        }
+        return r + 1 - M_size;
+      }
+      x = M_op1(M_c[r], x);
+    } while ((r & -r) != r);
+    return 0;
+  }
 };
 
 template <typename Tp>
@@ -143,3 +204,28 @@ struct range_sum_range_add {
     }
   };
 };
+
+template <typename Tp>
+struct range_sum_range_affine {
+  using first_type = std::pair<Tp, Tp>;
+  using second_type = std::pair<Tp, Tp>;
+  struct binary_operation {
+    first_type identity{0, 0};
+    first_type operator ()(first_type const& x, first_type const& y) const {
+      return {x.first+y.first, x.second+y.second};
+    }
+  };
+  struct external_binary_operation {
+    first_type operator ()(first_type const& x, second_type const& f) const {
+      // x -> ax+b applied to (sum, length)
+      return {f.first*x.first + f.second*x.second, x.second};
+    }
+  };
+  struct merge_operation {
+    second_type identity{1, 0};
+    second_type operator ()(second_type const& f, second_type const& g) const {
+      // g after f, which does not commute
+      return {g.first*f.first, g.first*f.second + g.second};
+    }
+  };
+};
@@ -1,32 +1,176 @@
 class bit_vector {
-  size_t n;
-  static constexpr size_t nbit = 64;
-  std::vector<intmax_t> raw;
-  std::vector<int> acc;
+  // Each 64-byte block holds a header word and then 448 bits, so that
+  // rank touches a single cache line (besides the superblock counts,
+  // which are few enough to stay in L1).  The header has the number of
+  // ones before the block in its superblock in the upper 32 bits, and
+  // those in the first 2, 4 and 6 words of the block in 9 bits each
+  // from the bottom, like rank9.  For select, the block of every
+  // S_sample-th one (and zero) is sampled, the block in question is
+  // found by scanning the counts from there (or bisecting, where the
+  // bits are skewed), and the bit in the word by pdep/tzcnt.  Where
+  // S_sample of them spread over S_sparse bits or more, their positions
+  // are kept as they are, as darray does.
+  static constexpr size_t S_words = 7;
+  static constexpr size_t S_bits = 64 * S_words;
+  static constexpr size_t S_super = 23;  // log of blocks per superblock
+  static constexpr size_t S_sample = 256;
+  static constexpr size_t S_scan = 8;
+  static constexpr size_t S_sparse = 1 << 18;
+  static constexpr uint32_t S_explicit = uint32_t(1) << 31;
+
+  struct alignas(64) block {
+    uint64_t count = 0;
+    uint64_t bits[S_words] = {};
+  };
+
+  size_t M_n = 0;
+  std::vector<block> M_b;  // followed by a sentinel
+  std::vector<size_t> M_super;
+  struct select_index {
+    // the block of each S_sample-th, or S_explicit | (where its
+    // positions begin in pos)
+    std::vector<uint32_t> sample;
+    std::vector<size_t> pos;  // plus one, as select returns
+  } M_s0, M_s1;
+
+  static size_t S_popcount(uint64_t x) { return __builtin_popcountll(x); }
+
+  static size_t S_select_word(uint64_t x, size_t k) {
+    // the position of the k-th (0-indexed) one in x
+#ifdef __BMI2__
+    return __builtin_ctzll(__builtin_ia32_pdep_di(uint64_t(1) << k, x));
+#else
+    for (; k > 0; --k) x &= x-1;
+    return __builtin_ctzll(x);
+#endif
+  }
+
+  static size_t S_sub(uint64_t count, size_t j) {
+    // ones in the first 2j words, for j in [0, 4)
+    return (count << 9) >> (9 * j) & 511;
+  }
+
+  template <int Bp>
+  size_t M_before(size_t i) const {
+    size_t ones = M_super[i >> S_super] + (M_b[i].count >> 32);
+    return Bp? ones: i * S_bits - ones;
+  }
+
+  template <int Bp>
+  void M_prepare_select(select_index& s) {
+    s.sample.clear();
+    for (size_t i = 0; i+1 < M_b.size(); ++i)
+      while (s.sample.size() * S_sample < M_before<Bp>(i+1)) s.sample.push_back(i);
+    s.sample.push_back(M_b.size()-2);
+
+    s.pos.clear();
+    size_t total = M_total<Bp>();
+    for (size_t g = 0; g+1 < s.sample.size(); ++g) {
+      if ((s.sample[g+1] - s.sample[g]) * S_bits < S_sparse) continue;
+      size_t first = s.pos.size();
+      for (size_t k = g * S_sample; k < total && k < (g+1) * S_sample; ++k)
+        s.pos.push_back(M_select<Bp>(k+1, s));
+      s.sample[g] = S_explicit | first;
+    }
+  }
+
+  size_t M_sample_block(select_index const& s, size_t g) const {
+    if (s.sample[g] & S_explicit) return (s.pos[s.sample[g] ^ S_explicit] - 1) / S_bits;
+    return s.sample[g];
+  }
+
+  template <int Bp>
+  size_t M_total() const {
+    size_t ones = M_before<1>(M_b.size()-1);
+    return Bp? ones: M_n - ones;
+  }
+
+  template <int Bp>
+  size_t M_select(size_t k, select_index const& s) const {
+    if (k == 0) return 0;
+    if (k > M_total<Bp>()) return -1;
+    size_t r = k-1;
+    if (s.sample[r / S_sample] & S_explicit)
+      return s.pos[(s.sample[r / S_sample] ^ S_explicit) + r % S_sample];
+
+    // the last block with at most r Bp's before it, which is between the
+    // blocks of two samples
+    size_t lb = s.sample[r / S_sample];
+    size_t ub = M_sample_block(s, r / S_sample + 1) + 1;
+    if (ub - lb <= S_scan) {
+      while (M_before<Bp>(lb+1) <= r) ++lb;
+    } else {
+      while (ub - lb > 1) {
+        size_t mid = (lb+ub) >> 1;
+        ((M_before<Bp>(mid) <= r)? lb: ub) = mid;
+      }
+    }
 
-  int popcount(uintmax_t x) const {
-    return __builtin_popcountll(x);
+    // then the pair of words by the header, and the word
+    r -= M_before<Bp>(lb);
+    block const& b = M_b[lb];
+    auto sub = [&](size_t j) { return Bp? S_sub(b.count, j): 128 * j - S_sub(b.count, j); };
+    size_t j = 2 * ((sub(1) <= r) + (sub(2) <= r) + (sub(3) <= r));
+    r -= sub(j / 2);
+    uint64_t x = (Bp? b.bits[j]: ~b.bits[j]);
+    size_t c = S_popcount(x);
+    if (r >= c) {
+      r -= c;
+      x = (Bp? b.bits[++j]: ~b.bits[++j]);
+    }
+    return lb * S_bits + j * 64 + S_select_word(x, r) + 1;
   }
 
 public:
   bit_vector() {}
 
-  bit_vector(const std::vector<bool>& b): n(b.size()) {
-    raw.assign(n/nbit+1, 0);
-    for (size_t i = 0; i < n; ++i)
-      if (b[i]) raw[i/nbit] |= intmax_t(1) << (i % nbit);
+  bit_vector(const std::vector<bool>& b): bit_vector(b.size()) {
+    for (size_t i = 0; i < M_n; ++i)
+      if (b[i]) M_b[i / S_bits].bits[i % S_bits / 64] |= uint64_t(1) << (i % 64);
+    build();
+  }
+
+  explicit bit_vector(size_t n): M_n(n), M_b(n / S_bits + 2) {
+    // n zeros, to be filled by set_word() and made queryable by build();
+    // distinct words can be set from distinct threads
+  }
 
-    acc.assign(n/nbit+1, 0);
-    for (size_t i = 1; i < acc.size(); ++i)
-      acc[i] = acc[i-1] + popcount(raw[i-1]);
+  void set_word(size_t i, uint64_t x) {
+    // bits [64i, 64i+64), with those past size() zero
+    M_b[i / S_words].bits[i % S_words] = x;
   }
 
+  void build() {
+    // the counts and samples, to be called once the words are set
+    M_super.assign((M_b.size() >> S_super) + 1, 0);
+    size_t ones = 0;
+    for (size_t i = 0; i < M_b.size(); ++i) {
+      if ((i & ((size_t(1) << S_super) - 1)) == 0) M_super[i >> S_super] = ones;
+      block& b = M_b[i];
+      size_t rel = ones - M_super[i >> S_super];
+      b.count = uint64_t(rel) << 32;
+      for (size_t j = 0; j < S_words; ++j) {
+        if (j > 0 && j % 2 == 0)
+          b.count |= uint64_t(ones - M_super[i >> S_super] - rel) << (9 * (j/2 - 1));
+        ones += S_popcount(b.bits[j]);
+      }
+    }
+    M_prepare_select<0>(M_s0);
+    M_prepare_select<1>(M_s1);
+  }
+
+
+  size_t size() const { return M_n; }
+
   size_t rank1(size_t k) const {
-    size_t large = k / nbit;
-    size_t small = k % nbit;
-    size_t res = acc[large];
-    if (small > 0) res += popcount(raw[large] & ((uintmax_t(1) << small) - 1));
-    return res;
+    size_t i = k / S_bits;
+    size_t small = k % S_bits;
+    size_t w = small / 64;
+    block const& b = M_b[i];
+    // the word before w, if odd, is counted with no branch
+    return M_super[i >> S_super] + (b.count >> 32) + S_sub(b.count, w / 2)
+      + S_popcount(b.bits[w & ~size_t(1)] & -uint64_t(w & 1))
+      + S_popcount(b.bits[w] & ((uint64_t(1) << (small % 64)) - 1));
   }
 
   size_t rank0(size_t k) const {
@@ -34,27 +178,12 @@ public:
   }
 
   size_t select1(size_t k) const {
-    if (k == 0) return 0;
-    size_t lb = 0;
-    size_t ub = n;
-    while (ub-lb > 1) {
-      size_t mid = (lb+ub) >> 1;
-      ((rank1(mid) < k)? lb:ub) = mid;
-    }
-    if (rank1(ub) < k) return -1;
-    return ub;
+    // the smallest i such that rank1(i) == k, or -1 if none
+    return M_select<1>(k, M_s1);
   }
 
   size_t select0(size_t k) const {
-    if (k == 0) return 0;
-    size_t lb = 0;
-    size_t ub = n;
-    while (ub-lb > 1) {
-      size_t mid = (lb+ub) >> 1;
-      ((rank0(mid) < k)? lb:ub) = mid;
-    }
-    if (rank0(ub) < k) return -1;
-    return ub;
+    return M_select<0>(k, M_s0);
   }
 
   size_t rank(int x, size_t k) const {
@@ -66,13 +195,16 @@ public:
   }
 
   bool operator [](size_t k) const {
-    size_t large = k / nbit;
-    size_t small = k % nbit;
-    return raw[large] >> small & 1;
+    return M_b[k / S_bits].bits[k % S_bits / 64] >> (k % 64) & 1;
+  }
+
+  void prefetch(size_t k) const {
+    // the line that rank(k) and operator [](k) read
+    __builtin_prefetch(&M_b[k / S_bits]);
   }
 };
 
-template <class Tp, size_t bitlen = 8 * sizeof(Tp)>
+template <class Tp, size_t bitlen = 8 * sizeof(Tp), class BitVector = bit_vector>
 class wavelet_matrix {
 public:
   using value_type = typename std::make_unsigned<Tp>::type;
@@ -81,7 +213,8 @@ private:
   std::vector<value_type> c;
   std::vector<size_t> zeros;
   size_t n;
-  std::array<bit_vector, bitlen> a;
+  std::array<BitVector, bitlen> a;
+  std::vector<std::vector<uint64_t>> sums;  // by build_sums()
 
   size_t start_index(value_type x) const {
     size_t s = 0;
@@ -99,26 +232,200 @@ private:
     return s;
   }
 
+  void M_partition(size_t j, std::vector<value_type>& whole, std::vector<value_type>& buf) {
+    // Sets the bits of level j from whole, and partitions whole stably
+    // by them in place, with the ones put aside in buf, in one pass.
+    size_t i = bitlen-j-1;
+    size_t z = 0;
+    size_t o = 0;
+    for (size_t w = 0; 64 * w < n; ++w) {
+      uint64_t x = 0;
+      for (size_t k = 64 * w; k < n && k < 64 * (w+1); ++k) {
+        // both are written, for the bits are hardly predictable
+        value_type v = whole[k];
+        uint64_t bit = v >> i & 1;
+        x |= bit << (k % 64);
+        buf[o] = whole[z] = v;
+        o += bit;
+        z += bit ^ 1;
+      }
+      a[j].set_word(w, x);
+    }
+    zeros[j] = z;
+    std::copy(buf.begin(), buf.begin()+o, whole.begin()+z);
+  }
+
+  void M_partition(size_t j, std::vector<value_type>& whole, std::vector<value_type>& buf,
+                   size_t threads) {
+    // The same with the values split into chunks (of whole words) among
+    // the threads: the zeros of each chunk are counted with the bits set,
+    // and then all are scattered to buf at the offsets thereby.
+    size_t i = bitlen-j-1;
+    size_t words = (n+63) / 64;
+    std::vector<size_t> lo(threads+1), num(threads+1);
+    for (size_t k = 0; k <= threads; ++k) lo[k] = std::min(n, words * k / threads * 64);
+
+    auto run = [&](auto fn) {
+      std::vector<std::thread> ths;
+      for (size_t k = 0; k < threads; ++k) ths.emplace_back(fn, k);
+      for (auto& th: ths) th.join();
+    };
+    run([&](size_t k) {
+      size_t ones = 0;
+      for (size_t w = lo[k] / 64; 64 * w < lo[k+1]; ++w) {
+        uint64_t x = 0;
+        for (size_t l = 64 * w; l < lo[k+1] && l < 64 * (w+1); ++l)
+          x |= uint64_t(whole[l] >> i & 1) << (l % 64);
+        a[j].set_word(w, x);
+        ones += __builtin_popcountll(x);
+      }
+      num[k+1] = (lo[k+1] - lo[k]) - ones;
+    });
+    for (size_t k = 0; k < threads; ++k) num[k+1] += num[k];
+    zeros[j] = num[threads];
+    run([&](size_t k) {
+      size_t z = num[k];
+      size_t o = zeros[j] + (lo[k] - num[k]);
+      for (size_t l = lo[k]; l < lo[k+1]; ++l) {
+        size_t bit = whole[l] >> i & 1;
+        buf[bit? o: z] = whole[l];
+        o += bit;
+        z += bit ^ 1;
+      }
+    });
+    whole.swap(buf);
+  }
+
+  static constexpr size_t batch_size = 256;
+
+  template <class State, class Step>
+  void M_descend_batch(std::vector<State>& st, Step step) const {
+    // Takes batch_size states at a time down the levels together, the
+    // step(j, state) of one state moving it from level j to the next.
+    // As the steps of one level are independent, their cache misses
+    // overlap, and the lines of the next level are prefetched for them.
+    for (size_t lo = 0; lo < st.size(); lo += batch_size) {
+      size_t hi = std::min(st.size(), lo + batch_size);
+      for (size_t q = lo; q < hi; ++q) {
+        a[0].prefetch(st[q].s);
+        a[0].prefetch(st[q].t);
+      }
+      for (size_t j = 0; j < bitlen; ++j) {
+        for (size_t q = lo; q < hi; ++q) {
+          step(j, st[q]);
+          if (j+1 < bitlen) {
+            a[j+1].prefetch(st[q].s);
+            a[j+1].prefetch(st[q].t);
+          }
+        }
+      }
+    }
+  }
+
+  struct path_state {
+    value_type x;
+    size_t s, t, lt, gt;
+  };
+
+  void M_three_way_batch(std::vector<path_state>& st) const {
+    // Follows x in [s, t), counting the values that leave the path
+    // into lt or gt; the rest (t-s at the end) are equal to x.
+    M_descend_batch(st, [&](size_t j, path_state& q) {
+      size_t i = bitlen-j-1;
+      size_t s0 = a[j].rank0(q.s);
+      size_t t0 = a[j].rank0(q.t);
+      if (q.x >> i & 1) {
+        q.lt += t0 - s0;
+        q.s = zeros[j] + (q.s - s0);
+        q.t = zeros[j] + (q.t - t0);
+      } else {
+        q.gt += (q.t - t0) - (q.s - s0);
+        q.s = s0;
+        q.t = t0;
+      }
+    });
+  }
+
+  template <class Nth>
+  std::vector<std::pair<bool, value_type>>
+  M_nth_batch(std::vector<std::tuple<value_type, size_t, size_t>> const& qs,
+              std::vector<path_state> const& st, Nth nth) const {
+    // the nth(state, s, t).second-th smallest in [s, t) if .first
+    std::vector<std::array<size_t, 3>> kst;
+    std::vector<std::pair<bool, value_type>> res(qs.size(), {false, 0});
+    for (size_t q = 0; q < qs.size(); ++q) {
+      size_t s = std::get<1>(qs[q]);
+      size_t t = std::get<2>(qs[q]);
+      auto [ok, k] = nth(st[q], s, t);
+      if (ok) kst.push_back({k, s, t});
+    }
+    auto found = quantile_batch(kst);
+    for (size_t q = 0, r = 0; q < qs.size(); ++q)
+      if (nth(st[q], std::get<1>(qs[q]), std::get<2>(qs[q])).first) res[q] = {true, found[r++]};
+    return res;
+  }
+
+  static value_type M_below(size_t i) {
+    // the bits up to i, that is, [0, i]
+    return (static_cast<value_type>(2) << i) - 1;
+  }
+
+  std::array<size_t, 3> M_three_way(value_type x, size_t s, size_t t,
+                                    uint64_t* lt_sum = nullptr) const {
+    // the numbers of values less than, equal to and greater than x in
+    // [s, t), and the sum of the less ones if lt_sum is given
+    if (x >> (bitlen-1) >> 1) {
+      // x is beyond bitlen bits
+      if (lt_sum) *lt_sum = sums[0][t] - sums[0][s];
+      return {t-s, 0, 0};
+    }
+    size_t lt = 0;
+    size_t gt = 0;
+    if (lt_sum) *lt_sum = 0;
+    for (size_t i = bitlen; i--;) {
+      size_t j = bitlen-i-1;
+      size_t s0 = a[j].rank0(s);
+      size_t t0 = a[j].rank0(t);
+      if (x >> i & 1) {
+        lt += t0 - s0;
+        if (lt_sum) *lt_sum += sums[j+1][t0] - sums[j+1][s0];
+        s = zeros[j] + (s - s0);
+        t = zeros[j] + (t - t0);
+      } else {
+        gt += (t - t0) - (s - s0);
+        s = s0;
+        t = t0;
+      }
+    }
+    return {lt, t-s, gt};
+  }
+
 public:
   template <class InputIt>
-  wavelet_matrix(InputIt first, InputIt last):
-    c(first, last), zeros(bitlen), n(c.size())
+  wavelet_matrix(InputIt first, InputIt last, bool keep_values = true, size_t threads = 1):
+    zeros(bitlen)
   {
-    std::vector<value_type> whole = c;
-    for (size_t i = bitlen; i--;) {
-      std::vector<value_type> zero, one;
-      std::vector<bool> vb(n);
-      for (size_t j = 0; j < n; ++j) {
-        ((whole[j] >> i & 1)? one:zero).push_back(whole[j]);
-        vb[j] = (whole[j] >> i & 1);
+    // Without keep_values, operator[] descends the levels rather than
+    // looking up a copy of the values.  With threads > 1, each level is
+    // partitioned by the threads together, while the rank and select
+    // directories of the last level are built by another one.
+    std::vector<value_type> whole(first, last);
+    n = whole.size();
+    if (keep_values) c = whole;
+    std::vector<value_type> buf(n);
+
+    std::vector<std::thread> builders;
+    for (size_t j = 0; j < bitlen; ++j) {
+      a[j] = BitVector(n);
+      if (threads > 1) {
+        M_partition(j, whole, buf, threads);
+        builders.emplace_back([this, j] { a[j].build(); });
+      } else {
+        M_partition(j, whole, buf);
+        a[j].build();
       }
-
-      zeros[bitlen-i-1] = zero.size();
-      a[bitlen-i-1] = bit_vector(vb);
-      if (i == 0) break;
-      whole = std::move(zero);
-      whole.insert(whole.end(), one.begin(), one.end());
     }
+    for (auto& th: builders) th.join();
   }
 
   size_t rank(value_type x, size_t t) const {
@@ -176,7 +483,7 @@ public:
         s = rs;
         t = rt;
         tight = false;
-        value_type mask = (static_cast<value_type>(1) << i) - 1;
+        value_type mask = (static_cast<value_type>(2) << ri) - 1;
         res |= mask;
         res ^= mask;
         reverted = true;
@@ -328,6 +635,101 @@ public:
     return {lt, eq, gt};
   }
 
+  size_t range_freq(size_t s, size_t t, value_type lo, value_type hi) const {
+    // the number of values x such that lo <= x <= hi in [s, t)
+    if (s == t || lo > hi) return 0;
+    return (t-s) - M_three_way(lo, s, t)[0] - M_three_way(hi, s, t)[2];
+  }
+
+  template <class Fn>
+  void range_list(size_t s, size_t t, value_type lo, value_type hi, Fn f) const {
+    // calls f(x, count) for each distinct value x such that lo <= x <= hi
+    // in [s, t), in increasing order of x, pruning the subtrees out of
+    // [lo, hi]; O(log(sigma)) per value
+    auto dfs = [&](auto& self, size_t j, size_t s, size_t t, value_type x) -> void {
+      if (s == t) return;
+      value_type last = ((j < bitlen)? (x | M_below(bitlen-j-1)): x);
+      if (last < lo || hi < x) return;
+      if (j == bitlen) {
+        f(x, t-s);
+        return;
+      }
+      size_t s0 = a[j].rank0(s);
+      size_t t0 = a[j].rank0(t);
+      self(self, j+1, s0, t0, x);
+      self(self, j+1, zeros[j] + (s - s0), zeros[j] + (t - t0),
+           static_cast<value_type>(x | static_cast<value_type>(1) << (bitlen-j-1)));
+    };
+    dfs(dfs, 0, s, t, 0);
+  }
+
+  std::vector<std::pair<value_type, size_t>> topk_frequent(size_t s, size_t t, size_t k) const {
+    // the k most frequent values in [s, t) with their counts, the more
+    // frequent (and the less, if as frequent) first.  Subtrees are taken
+    // from a heap in decreasing order of their sizes, which bound the
+    // counts of the values in them, until k leaves are taken; so those
+    // larger than the k-th count are all expanded, O(log(sigma)) each.
+    // This is O(k log(sigma)) when the top k stand out, but O((t-s)
+    // log(sigma)) when all the counts are small (e.g., distinct values).
+    struct node {
+      size_t j, s, t;
+      value_type x;
+    };
+    auto later = [](node const& u, node const& v) {
+      if (u.t-u.s != v.t-v.s) return u.t-u.s < v.t-v.s;
+      return u.x > v.x;
+    };
+    std::vector<node> heap;
+    auto push = [&](node u) {
+      heap.push_back(u);
+      std::push_heap(heap.begin(), heap.end(), later);
+    };
+    std::vector<std::pair<value_type, size_t>> res;
+    if (s < t) push({0, s, t, 0});
+    while (!heap.empty() && res.size() < k) {
+      std::pop_heap(heap.begin(), heap.end(), later);
+      node cur = heap.back();
+      heap.pop_back();
+      if (cur.j == bitlen) {
+        res.emplace_back(cur.x, cur.t-cur.s);
+        continue;
+      }
+      size_t j = cur.j;
+      size_t s0 = a[j].rank0(cur.s);
+      size_t t0 = a[j].rank0(cur.t);
+      if (s0 < t0) push({j+1, s0, t0, cur.x});
+      if (cur.t-t0 > cur.s-s0)
+        push({j+1, zeros[j] + (cur.s - s0), zeros[j] + (cur.t - t0),
+              static_cast<value_type>(cur.x | static_cast<value_type>(1) << (bitlen-j-1))});
+    }
+    return res;
+  }
+
+  void build_sums() {
+    // Prefix sums of the values in the order of each level, for
+    // range_sum(), taking (bitlen+1) (n+1) words.  Sums wrap around
+    // modulo 2^64.
+    std::vector<value_type> whole(n);
+    for (size_t i = 0; i < n; ++i) whole[i] = (*this)[i];
+    sums.assign(bitlen+1, std::vector<uint64_t>(n+1));
+    for (size_t j = 0; j <= bitlen; ++j) {
+      for (size_t k = 0; k < n; ++k) sums[j][k+1] = sums[j][k] + whole[k];
+      if (j == bitlen) break;
+      size_t i = bitlen-j-1;
+      std::stable_partition(whole.begin(), whole.end(), [i](value_type x) { return !(x >> i & 1); });
+    }
+  }
+
+  uint64_t range_sum(size_t s, size_t t, value_type lo, value_type hi) const {
+    // the sum of values x such that lo <= x <= hi in [s, t), which needs
+    // build_sums() beforehand
+    if (s == t || lo > hi) return 0;
+    uint64_t lt_lo, lt_hi;
+    M_three_way(lo, s, t, &lt_lo);
+    auto hi3 = M_three_way(hi, s, t, &lt_hi);
+    return lt_hi + uint64_t(hi) * hi3[1] - lt_lo;
+  }
+
   size_t select(value_type x, size_t t) const {
     if (t == 0) return 0;
     size_t si = start_index(x);
@@ -343,7 +745,101 @@ public:
     return t;
   }
 
-  value_type operator [](size_t t) const { return c[t]; }
+  // The batch versions answer many queries at once, level by level, and
+  // return the answers in the same order.
+
+  std::vector<size_t> rank_batch(std::vector<std::pair<value_type, size_t>> const& qs) const {
+    // {x, t} for rank(x, t)
+    std::vector<path_state> st(qs.size());
+    for (size_t q = 0; q < qs.size(); ++q) st[q] = {qs[q].first, 0, qs[q].second, 0, 0};
+    M_three_way_batch(st);
+    std::vector<size_t> res(qs.size());
+    for (size_t q = 0; q < qs.size(); ++q) res[q] = st[q].t - st[q].s;
+    return res;
+  }
+
+  std::vector<std::array<size_t, 3>>
+  rank_three_way_batch(std::vector<std::pair<value_type, size_t>> const& qs) const {
+    // {x, t} for rank_three_way(x, t)
+    std::vector<path_state> st(qs.size());
+    for (size_t q = 0; q < qs.size(); ++q) st[q] = {qs[q].first, 0, qs[q].second, 0, 0};
+    M_three_way_batch(st);
+    std::vector<std::array<size_t, 3>> res(qs.size());
+    for (size_t q = 0; q < qs.size(); ++q) res[q] = {st[q].lt, st[q].t - st[q].s, st[q].gt};
+    return res;
+  }
+
+  std::vector<value_type> quantile_batch(std::vector<std::array<size_t, 3>> const& qs) const {
+    // {k, s, t} for quantile(k, s, t)
+    struct state {
+      size_t k, s, t;
+      value_type res;
+    };
+    std::vector<state> st(qs.size());
+    for (size_t q = 0; q < qs.size(); ++q) st[q] = {qs[q][0], qs[q][1], qs[q][2], 0};
+    M_descend_batch(st, [&](size_t j, state& q) {
+      size_t i = bitlen-j-1;
+      size_t s0 = a[j].rank0(q.s);
+      size_t t0 = a[j].rank0(q.t);
+      if (q.k < t0 - s0) {
+        q.s = s0;
+        q.t = t0;
+      } else {
+        q.res |= static_cast<value_type>(1) << i;
+        q.k -= t0 - s0;
+        q.s = zeros[j] + (q.s - s0);
+        q.t = zeros[j] + (q.t - t0);
+      }
+    });
+    std::vector<value_type> res(qs.size());
+    for (size_t q = 0; q < qs.size(); ++q) res[q] = st[q].res;
+    return res;
+  }
+
+  std::vector<std::pair<bool, value_type>>
+  min_ge_batch(std::vector<std::tuple<value_type, size_t, size_t>> const& qs) const {
+    // {x, s, t} for min_ge(x, s, t), as the (number of values less
+    // than x)-th smallest, which is two batches of plain descents
+    std::vector<path_state> st(qs.size());
+    for (size_t q = 0; q < qs.size(); ++q) {
+      auto [x, s, t] = qs[q];
+      st[q] = {x, s, t, 0, 0};
+    }
+    M_three_way_batch(st);
+    return M_nth_batch(qs, st, [](path_state const& q, size_t s, size_t t) {
+      return std::make_pair(q.lt < t-s, q.lt);
+    });
+  }
+
+  std::vector<std::pair<bool, value_type>>
+  max_le_batch(std::vector<std::tuple<value_type, size_t, size_t>> const& qs) const {
+    // {x, s, t} for max_le(x, s, t), likewise
+    std::vector<path_state> st(qs.size());
+    for (size_t q = 0; q < qs.size(); ++q) {
+      auto [x, s, t] = qs[q];
+      st[q] = {x, s, t, 0, 0};
+    }
+    M_three_way_batch(st);
+    return M_nth_batch(qs, st, [](path_state const& q, size_t s, size_t t) {
+      size_t le = (t-s) - q.gt;
+      return std::make_pair(le > 0, le-1);
+    });
+  }
+
+  value_type operator [](size_t t) const {
+    if (!c.empty()) return c[t];
+    value_type res = 0;
+    for (size_t i = bitlen; i--;) {
+      size_t j = bitlen-i-1;
+      if (a[j][t]) {
+        res |= static_cast<value_type>(1) << i;
+        t = zeros[j] + a[j].rank1(t);
+      } else {
+        t = a[j].rank0(t);
+      }
+    }
+    return res;
+  }
 
   void inspect() const {
     for (size_t i = 0; i < bitlen; ++i) {
@@ -0,0 +1,183 @@
+template <
+  typename Monoid,
+  size_t Fanout = std::max<size_t>(2, 64 / sizeof(typename Monoid::first_type))
+>
+class wide_segment_tree {
+  // basic_segment_tree for read-heavy use, with Fanout children per node
+  // instead of two, so that the tree is log_Fanout(n) levels high.  Each
+  // level is an array of blocks of Fanout values (a cache line for the
+  // default), the i-th value on a level being the fold of the i-th block
+  // below.  Each block also has the prefix and suffix folds of its
+  // values, so that a fold takes one value per level and side, and
+  // only the block where the bounds meet is folded value by value.  The
+  // blocks read are known from the bounds alone, so that their loads do
+  // not wait for each other.  This takes three times the memory, and an
+  // update rescans a block per level.
+public:
+  using size_type = size_t;
+  using first_type = typename Monoid::first_type;
+  using second_type = typename Monoid::second_type;
+  using value_type = first_type;
+  using binary_operation = typename Monoid::binary_operation;
+  using external_binary_operation = typename Monoid::external_binary_operation;
+
+private:
+  struct alignas(64) block {
+    value_type c[Fanout];
+  };
+
+  size_type M_base_size = 0;
+  binary_operation M_op1;
+  external_binary_operation M_op2;
+  std::vector<block> M_c;
+  std::vector<block> M_pre;  // M_pre[v].c[j]: the fold of M_c[v].c[0..j]
+  std::vector<block> M_suf;  // M_suf[v].c[j]: the fold of M_c[v].c[j..Fanout)
+  std::vector<size_type> M_offset;  // of each level in M_c, from the leaves
+
+  value_type M_fold(size_type v, size_type l, size_type r) const {
+    // the fold of M_c[v].c[l..r), for l < r
+    if (l == 0) return M_pre[v].c[r-1];
+    if (r == Fanout) return M_suf[v].c[l];
+    value_type res = M_c[v].c[l];
+    for (size_type j = l+1; j < r; ++j)
+      res = M_op1(res, M_c[v].c[j]);
+    return res;
+  }
+
+  void M_scan(size_type v) {
+    // the prefix and suffix folds of the block v
+    block const& b = M_c[v];
+    value_type x = M_op1.identity;
+    for (size_type j = 0; j < Fanout; ++j) M_pre[v].c[j] = x = M_op1(x, b.c[j]);
+    x = M_op1.identity;
+    for (size_type j = Fanout; j--;) M_suf[v].c[j] = x = M_op1(b.c[j], x);
+  }
+
+  void M_build() {
+    for (size_type k = 0; k < M_levels(); ++k) {
+      size_type n = M_offset[k+1] - M_offset[k];
+      for (size_type i = 0; i < n; ++i) {
+        M_scan(M_offset[k] + i);
+        if (k+1 < M_levels())
+          M_c[M_offset[k+1] + i / Fanout].c[i % Fanout] = M_pre[M_offset[k] + i].c[Fanout-1];
+      }
+    }
+  }
+
+  void M_update(size_type i) {
+    for (size_type k = 0; k < M_levels(); ++k) {
+      size_type v = M_offset[k] + i / Fanout;
+      M_scan(v);
+      if (k+1 == M_levels()) break;
+      i /= Fanout;
+      M_c[M_offset[k+1] + i / Fanout].c[i % Fanout] = M_pre[v].c[Fanout-1];
+    }
+  }
+
+  void M_init(size_type n) {
+    // the levels, filled with the identity
+    M_base_size = n;
+    M_offset.assign(1, 0);
+    size_type blocks = 0;
+    do {
+      n = std::max<size_type>(1, (n + Fanout - 1) / Fanout);
+      M_offset.push_back(blocks += n);
+    } while (n > 1);
+
+    block id;
+    std::fill(id.c, id.c + Fanout, M_op1.identity);
+    M_c.assign(blocks, id);
+    M_pre.resize(blocks);
+    M_suf.resize(blocks);
+  }
+
+  size_type M_levels() const { return M_offset.size() - 1; }
+
+  value_type& M_leaf(size_type i) { return M_c[i / Fanout].c[i % Fanout]; }
+  value_type const& M_leaf(size_type i) const { return M_c[i / Fanout].c[i % Fanout]; }
+
+public:
+  wide_segment_tree() = default;
+  wide_segment_tree(wide_segment_tree const&) = default;
+  wide_segment_tree(wide_segment_tree&&) = default;
+
+  wide_segment_tree(size_type n, first_type const& x = binary_operation().identity):
+    M_op1(binary_operation()), M_op2(external_binary_operation())
+  { assign(n, x); }
+
+  template <typename InputIt>
+  wide_segment_tree(InputIt first, InputIt last):
+    M_op1(binary_operation()), M_op2(external_binary_operation())
+  { assign(first, last); }
+
+  wide_segment_tree& operator =(wide_segment_tree const&) = default;
+  wide_segment_tree& operator =(wide_segment_tree&&) = default;
+
+  void assign(size_type n, value_type const& x) {
+    M_init(n);
+    for (size_type i = 0; i < n; ++i) M_leaf(i) = x;
+    M_build();
+  }
+
+  template <typename InputIt>
+  void assign(InputIt first, InputIt last) {
+    std::vector<value_type> tmp(first, last);
+    M_init(tmp.size());
+    for (size_type i = 0; i < tmp.size(); ++i) M_leaf(i) = tmp[i];
+    M_build();
+  }
+
+  size_type size() const { return M_base_size; }
+
+  void modify(size_type i, second_type const& x) {
+    M_leaf(i) = M_op2(M_leaf(i), x);
+    M_update(i);
+  }
+
+  void assign_at(size_type i, value_type const& x) {
+    M_leaf(i) = x;
+    M_update(i);
+  }
+
+  value_type const& operator [](size_type i) const { return M_leaf(i); }
+
+  value_type accumulate(size_type l, size_type r) const {
+    value_type resl = M_op1.identity;
+    value_type resr = resl;
+    for (size_type k = 0; l < r; ++k) {
+      size_type base = M_offset[k];
+      size_type lb = l / Fanout;
+      size_type rb = r / Fanout;
+      if (lb == rb || k+1 == M_levels()) {
+        // the bounds meet in a block (at the top, the only one)
+        resl = M_op1(resl, M_fold(base + lb, l - lb * Fanout, r - lb * Fanout));
+        break;
+      }
+      if (l % Fanout) resl = M_op1(resl, M_suf[base + lb++].c[l % Fanout]);
+      if (r % Fanout) resr = M_op1(M_pre[base + rb].c[r % Fanout - 1], resr);
+      l = lb;
+      r = rb;
+    }
+    return M_op1(resl, resr);
+  }
+
+  template <typename Predicate>
+  std::pair<size_type, value_type> partition_point(Predicate pred) const {
+    // as basic_segment_tree::partition_point(), from the top down
+    value_type x = M_op1.identity;
+    size_type i = 0;
+    for (size_type k = M_levels(); k--;) {
+      block const& b = M_c[M_offset[k] + i];
+      size_type j = 0;
+      for (; j < Fanout; ++j) {
+        value_type y = M_op1(x, b.c[j]);
+        if (!pred(y)) break;
+        x = y;
+      }
+      if (j == Fanout) return {M_base_size, x};
+      i = i * Fanout + j;
+      if (k > 0) __builtin_prefetch(&M_c[M_offset[k-1] + i]);
+    }
+    return {i, x};
+  }
+};
@@ -2,151 +2,899 @@
 #include <cstdint>
 #include <cstddef>
 #include <cstring>
+#include <cstdlib>
+#include <charconv>
+#include <string_view>
 #include <utility>
 #include <type_traits>
 #include <limits>
+#include <algorithm>
+#include <memory>
+#include <new>
+#include <system_error>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <cerrno>
 
 namespace fast {
   // fast I/O by rsk0315 (update: 2019-10-14 16:56:15).
-  // This version supports only integer inputs/outputs, single character
-  // outputs, and string literal outputs.
+  // This version supports integer and floating-point inputs/outputs,
+  // string inputs, single character outputs, and string literal outputs.
   static size_t constexpr buf_size = 1 << 17;
-  static size_t constexpr margin = 1;
+  static size_t constexpr margin = 64;  // for overrunning (SIMD) loads
   static char inbuf[buf_size + margin] = {};
   static char outbuf[buf_size + margin] = {};
   static __attribute__((aligned(8))) char minibuf[32];
   static size_t constexpr int_digits = 20;  // 18446744073709551615
+  static size_t constexpr float_chars = 64;  // longer tokens are truncated
+  static size_t constexpr shortest_chars = 24;  // -2.2250738585072014e-308
+  static size_t constexpr fixed_chars = 311;  // '-', digits of 1.8e308, and '.'
   static uintmax_t constexpr digit_mask = 0x3030303030303030;
+  static uintmax_t constexpr value_mask = 0x0F0F0F0F0F0F0F0F;
   static uintmax_t constexpr first_mask = 0x00FF00FF00FF00FF;
   static uintmax_t constexpr second_mask = 0x0000FFFF0000FFFF;
   static uintmax_t constexpr third_mask = 0x00000000FFFFFFFF;
   static uintmax_t constexpr tenpow[] = {
-    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000,
+    1000000000, 10000000000, 100000000000, 1000000000000, 10000000000000,
+    100000000000000, 1000000000000000, 10000000000000000,
+    100000000000000000, 1000000000000000000, 10000000000000000000u
   };
   template <typename Tp>
   using enable_if_integral = std::enable_if<std::is_integral<Tp>::value, Tp>;
 
-  class scanner {
-    char* pos = inbuf;
-    char* endpos = inbuf + buf_size;
+  struct digit_pair_table {
+    // "00", "01", ..., "99"
+    char c[200];
+    constexpr digit_pair_table(): c() {
+      for (int i = 0; i < 100; ++i) {
+        c[2*i] = '0' + i/10;
+        c[2*i+1] = '0' + i%10;
+      }
+    }
+  };
+  static digit_pair_table constexpr digit_pairs{};
+
+  inline int count_digits(uintmax_t y) {
+    // the number of digits of y, guessed from its bit length (log10(2)
+    // ~= 1233/4096) and then corrected; y|1 has as many digits as y.
+    y |= 1;
+    int t = (64 - __builtin_clzll(y)) * 1233 >> 12;
+    return t + (y >= tenpow[t]);
+  }
 
-    void M_read_from_stdin() {
-      endpos = inbuf + fread(pos, 1, buf_size, stdin);
+  inline void write_digits(char* p, uintmax_t y, int len) {
+    // writes y (having exactly len digits) into p[0..len), two at a time
+    while (y >= 100) {
+      size_t i = y % 100 * 2;
+      y /= 100;
+      p[--len] = digit_pairs.c[i+1];
+      p[--len] = digit_pairs.c[i];
     }
-    void M_reread_from_stdin() {
-      ptrdiff_t len = endpos - pos;
-      if (!(inbuf + len <= pos)) return;
-      memcpy(inbuf, pos, len);
-      char* tmp = inbuf + len;
-      endpos = tmp + fread(tmp, 1, buf_size-len, stdin);
-      *endpos = 0;
-      pos = inbuf;
+    if (y >= 10) {
+      memcpy(p, digit_pairs.c + y*2, 2);
+    } else {
+      *p = '0' + y;
     }
+  }
 
-  public:
-    scanner() { M_read_from_stdin(); }
+  // token_mask(p) has its i-th bit set iff p[i] is a non-whitespace
+  // character, for i in [0, window_size).  Reading p[window_size-1]
+  // must be safe; inbuf has a margin for that.
+#if defined(__AVX2__)
+  static size_t constexpr window_size = 64;
+  inline uintmax_t token_mask(char const* p) {
+    __m256i sp = _mm256_set1_epi8(' ');
+    __m256i lo = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(p));
+    __m256i hi = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(p+32));
+    uint32_t mlo = _mm256_movemask_epi8(_mm256_cmpgt_epi8(lo, sp));
+    uint32_t mhi = _mm256_movemask_epi8(_mm256_cmpgt_epi8(hi, sp));
+    return uintmax_t(mhi) << 32 | mlo;
+  }
+#elif defined(__SSE2__)
+  static size_t constexpr window_size = 32;
+  inline uintmax_t token_mask(char const* p) {
+    __m128i sp = _mm_set1_epi8(' ');
+    __m128i lo = _mm_loadu_si128(reinterpret_cast<__m128i const*>(p));
+    __m128i hi = _mm_loadu_si128(reinterpret_cast<__m128i const*>(p+16));
+    uint32_t mlo = _mm_movemask_epi8(_mm_cmpgt_epi8(lo, sp));
+    uint32_t mhi = _mm_movemask_epi8(_mm_cmpgt_epi8(hi, sp));
+    return mhi << 16 | mlo;
+  }
+#else
+  static size_t constexpr window_size = 8;
+  inline uintmax_t token_mask(char const* p) {
+    // For an ASCII byte c, (c + 0x5F) has its MSB set iff c > ' '.
+    uintmax_t c;
+    memcpy(&c, p, 8);
+    c = (c + 0x5F5F5F5F5F5F5F5F) & 0x8080808080808080;
+    return (c * 0x0002040810204081) >> 56;
+  }
+#endif
 
-    template <typename Integral,
-              typename enable_if_integral<Integral>::type* = nullptr>
-    void scan_parallel(Integral& x) {
-      // See https://qiita.com/rsk0315_h4x/items/17a9cb12e0de5fd918f4
-      if (__builtin_expect(endpos <= pos + int_digits, 0))
-        M_reread_from_stdin();
-      bool ends = false;
-      typename std::make_unsigned<Integral>::type y = 0;
+  inline uintmax_t parse_eight(uintmax_t c) {
+    // in the same manner as scanner::scan_parallel()
+    c &= value_mask;
+    c = ((c >> 8) + c*10) & first_mask;
+    c = ((c >> 16) + c*100) & second_mask;
+    c = ((c >> 32) + c*10000) & third_mask;
+    return c;
+  }
+
+  inline uintmax_t parse_sixteen(char const* s, size_t len) {
+    // converts s[0..len) for 1 <= len <= 16 without branches; the bytes
+    // after the token are shifted out.
+    unsigned __int128 c;
+    memcpy(&c, s, 16);
+    c <<= 8 * (16-len);
+    return parse_eight(c) * tenpow[8] + parse_eight(c >> 64);
+  }
+
+  template <typename Integral>
+  Integral parse_token(char const* s, char const* e) {
+    bool neg = false;
+    if (std::is_signed<Integral>::value && *s == '-') {
+      neg = true;
+      ++s;
+    }
+    size_t len = e - s;
+    uintmax_t y;
+    if (__builtin_expect(len <= 16, 1)) {
+      y = parse_sixteen(s, len);
+    } else {
+      y = parse_sixteen(s, len-16);
+      y = y * (tenpow[8] * tenpow[8]) + parse_sixteen(s+len-16, 16);
+    }
+    typename std::make_unsigned<Integral>::type z = y;
+    return (neg? -z: z);
+  }
+
+  template <typename Integral>
+  void scan_window(char*& pos, char const* endpos, Integral* out, size_t& i, size_t n) {
+    // Parses the tokens in [pos, pos+window_size) into out[i..n).  Any
+    // token starting there must be terminated before endpos, or by the
+    // zero at *endpos.
+    size_t avail = std::min<size_t>(endpos - pos, window_size);
+    uintmax_t m = token_mask(pos);
+    if (avail < window_size) m &= (uintmax_t(1) << avail) - 1;
+    if (m == 0) {
+      pos += avail;
+      return;
+    }
+    char* base = pos;
+    do {
+      size_t start = __builtin_ctzll(m);
+      uintmax_t rest = m >> start;
+      size_t end = (~rest == 0)? window_size: start + __builtin_ctzll(~rest);
+      char* e = base + end;
+      if (__builtin_expect(end == window_size, 0)) {
+        // the token may continue over the window
+        if (start > 0) {
+          pos = base + start;
+          return;
+        }
+        while (*e > ' ') ++e;
+      }
+      out[i++] = parse_token<Integral>(base + start, e);
+      pos = e + (e < endpos);
+      m = (end < window_size)? (m >> end << end): 0;
+    } while (m != 0 && i < n);
+  }
+
+  inline size_t count_tokens(char const* p, char const* e) {
+    // the number of tokens starting in [p, e)
+    size_t res = 0;
+    uintmax_t carry = 0;  // whether the previous byte was in a token
+    for (; p < e; p += window_size) {
+      size_t avail = std::min<size_t>(e - p, window_size);
+      uintmax_t m = token_mask(p);
+      if (avail < window_size) m &= (uintmax_t(1) << avail) - 1;
+      res += __builtin_popcountll(m & ~(m << 1 | carry));
+      carry = m >> (window_size-1) & 1;
+    }
+    return res;
+  }
+
+  // Digit policies: parse(p, x) reads an integer (with an optional '-'
+  // for signed types) starting at p, and returns the position of the
+  // delimiter, i.e. the first byte below '0'.  At most lookahead bytes
+  // from p are read, all of which must be in the buffer or its margin.
+  struct serial_digits {
+    static size_t constexpr lookahead = int_digits + 2;
+    template <typename Integral>
+    static char* parse(char* p, Integral& x) {
+      bool neg = false;
+      if (std::is_signed<Integral>::value && *p == '-') {
+        neg = true;
+        ++p;
+      }
+      typename std::make_unsigned<Integral>::type y = *p-'0';
+      while (*++p >= '0') y = 10*y + *p-'0';
+      x = (neg? -y: y);
+      return p;
+    }
+  };
+
+  struct swar_digits {
+    // See https://qiita.com/rsk0315_h4x/items/17a9cb12e0de5fd918f4
+    static size_t constexpr lookahead = int_digits + 2 + 8;
+    template <typename Integral>
+    static char* parse(char* p, Integral& x) {
       bool neg = false;
-      if (std::is_signed<Integral>::value && *pos == '-') {
+      if (std::is_signed<Integral>::value && *p == '-') {
         neg = true;
-        ++pos;
+        ++p;
       }
+      typename std::make_unsigned<Integral>::type y = 0;
+      bool ends = false;
       do {
-        memcpy(minibuf, pos, 8);
-        long c = *(long*)minibuf;
-        long d = (c & digit_mask) ^ digit_mask;
+        uintmax_t c;
+        memcpy(&c, p, 8);
+        uintmax_t d = (c & digit_mask) ^ digit_mask;
         int skip = 8;
         int shift = 8;
         if (d) {
-          int ctz = __builtin_ctzl(d);
+          int ctz = __builtin_ctzll(d);
           if (ctz == 4) break;
-          c &= (1L << (ctz-5)) - 1;
+          c &= (uintmax_t(1) << (ctz-5)) - 1;
           int discarded = (68-ctz) / 8;
           shift -= discarded;
           c <<= discarded * 8;
           skip -= discarded;
           ends = true;
         }
-        c |= digit_mask;
-        c ^= digit_mask;
-        c = ((c >> 8) + c*10) & first_mask;
-        c = ((c >> 16) + c*100) & second_mask;
-        c = ((c >> 32) + c*10000) & third_mask;
-        y = y*tenpow[shift] + c;
-        pos += skip;
+        y = y*tenpow[shift] + parse_eight(c);
+        p += skip;
       } while (!ends);
       x = (neg? -y: y);
-      ++pos;
+      return p;
     }
+  };
 
-    template <typename Integral,
-              typename enable_if_integral<Integral>::type* = nullptr>
-    void scan_serial(Integral& x) {
-      if (__builtin_expect(endpos <= pos + int_digits, 0))
-        M_reread_from_stdin();
+#if defined(__SSE4_1__)
+  struct shuffle_table {
+    // m[len] moves the first len bytes to the end, zeroing the rest
+    char m[17][16];
+    constexpr shuffle_table(): m() {
+      for (int len = 0; len <= 16; ++len)
+        for (int i = 0; i < 16; ++i)
+          m[len][i] = (i >= 16-len)? i-(16-len): -128;
+    }
+  };
+  static shuffle_table constexpr right_align{};
+
+  struct simd_digits {
+    // The delimiter is found by a 16-byte comparison, and the (up to)
+    // sixteen digits are right-aligned by pshufb and then combined by
+    // multiply-adds: 1+1 -> 2 -> 4 -> 8 digits per lane.
+    static size_t constexpr lookahead = int_digits + 2 + 16;
+
+    template <typename Integral>
+    static char* parse(char* p, Integral& x) {
       bool neg = false;
-      if (std::is_signed<Integral>::value && *pos == '-') {
+      if (std::is_signed<Integral>::value && *p == '-') {
         neg = true;
-        ++pos;
+        ++p;
       }
-      typename std::make_unsigned<Integral>::type y = *pos-'0';
-      while (*++pos >= '0') y = 10*y + *pos-'0';
-      x = (neg? -y: y);
-      ++pos;
+      __m128i v = _mm_loadu_si128(reinterpret_cast<__m128i const*>(p));
+      v = _mm_sub_epi8(v, _mm_set1_epi8('0'));
+      // bytes below '0' wrap to [-48, -1] (and those above '9' are not
+      // expected), so the delimiter is the first negative byte.
+      uint32_t nondigit = _mm_movemask_epi8(v) | 0x10000;
+      int len = __builtin_ctz(nondigit);
+      v = _mm_shuffle_epi8(v, _mm_loadu_si128(
+          reinterpret_cast<__m128i const*>(right_align.m[len])));
+      v = _mm_maddubs_epi16(v, _mm_set1_epi16(0x010A));  // 10, 1
+      v = _mm_madd_epi16(v, _mm_set1_epi32(0x00010064));  // 100, 1
+      v = _mm_packus_epi32(v, v);
+      v = _mm_madd_epi16(v, _mm_set1_epi32(0x00012710));  // 10000, 1
+      uintmax_t y = uint32_t(_mm_cvtsi128_si32(v)) * tenpow[8]
+        + uint32_t(_mm_extract_epi32(v, 1));
+      p += len;
+      if (__builtin_expect(len == 16, 0))
+        for (; *p >= '0'; ++p) y = 10*y + *p-'0';
+      typename std::make_unsigned<Integral>::type z = y;
+      x = (neg? -z: z);
+      return p;
+    }
+  };
+#else
+  using simd_digits = swar_digits;
+#endif
+
+  struct auto_digits {
+    // Picks one of the above by the width of the type, as measured by
+    // bonsai/FIO/digits.cpp on tokens of mixed lengths: the byte loop
+    // for at most three digits, SWAR for 16-bit, and SIMD otherwise.
+    static size_t constexpr lookahead = simd_digits::lookahead;
+    template <typename Integral>
+    static char* parse(char* p, Integral& x) {
+      using policy = typename std::conditional<
+        (sizeof(Integral) == 1), serial_digits,
+        typename std::conditional<
+          (sizeof(Integral) == 2), swar_digits, simd_digits>::type>::type;
+      return policy::parse(p, x);
+    }
+  };
+
+  // Floating-point conversions are delegated to <charconv>: from_chars
+  // is correctly rounded with an Eisel-Lemire fast path (falling back to
+  // big integers only for ambiguous halfway cases), and to_chars gives
+  // the shortest round-trip representation (Ryu) or exact fixed digits.
+  inline char* parse_double(char* s, char* e, double& x) {
+    return const_cast<char*>(std::from_chars(s, e, x).ptr);
+  }
+  inline char* format_shortest(char* p, char* e, double x) {
+    return std::to_chars(p, e, x).ptr;
+  }
+  inline char* format_fixed(char* p, char* e, double x, int precision) {
+    // nullptr if [p, e) is too short
+    auto res = std::to_chars(p, e, x, std::chars_format::fixed, precision);
+    return (res.ec == std::errc())? res.ptr: nullptr;
+  }
+
+  // Sources: read(pos, endpos) sets up the buffer [pos, endpos) with
+  // *endpos == 0 and a margin after it.  If refills is true, reread()
+  // moves the unread part [pos, endpos) to the front and fills the rest,
+  // and the buffer may start empty; otherwise the whole input is
+  // available from the beginning.
+
+  class stdio_reader {
+    // Reads stdin into inbuf synchronously.  Nothing is read until the
+    // first reread(), so that a scanner never used (such as the global
+    // cin) leaves stdin intact for other readers.
+  public:
+    static bool constexpr refills = true;
+    void read(char*& pos, char*& endpos) {
+      pos = endpos = inbuf;
+      *endpos = 0;
+    }
+    void reread(char*& pos, char*& endpos) {
+      // does nothing if the unread part and the front would overlap
+      ptrdiff_t len = endpos - pos;
+      if (!(inbuf + len <= pos)) return;
+      memcpy(inbuf, pos, len);
+      char* tmp = inbuf + len;
+      endpos = tmp + fread(tmp, 1, buf_size-len, stdin);
+      *endpos = 0;
+      pos = inbuf;
+    }
+  };
+
+  class prefetching_reader {
+    // Double buffering: a producer thread fills one buffer with fread
+    // while the scanner parses the other.  On reread(), the unread tail
+    // is copied into the front room of the next buffer, and the current
+    // one is handed back to the producer.
+    static size_t constexpr front = 256;
+    struct buffer {
+      char data[front + buf_size + margin];
+      size_t len = 0;
+      bool full = false;
+    };
+    std::unique_ptr<buffer[]> M_buf;
+    size_t M_cur = 0;
+    bool M_eof = false;
+    bool M_stop = false;
+    std::mutex M_mtx;
+    std::condition_variable M_cv;
+    std::thread M_producer;
+
+    void M_produce() {
+      for (size_t k = 0; true; k ^= 1) {
+        {
+          std::unique_lock<std::mutex> lock(M_mtx);
+          M_cv.wait(lock, [&] { return M_stop || !M_buf[k].full; });
+          if (M_stop) return;
+        }
+        size_t len = fread(M_buf[k].data + front, 1, buf_size, stdin);
+        {
+          std::lock_guard<std::mutex> lock(M_mtx);
+          M_buf[k].len = len;
+          M_buf[k].full = true;
+        }
+        M_cv.notify_all();
+        if (len == 0) return;
+      }
+    }
+
+    buffer& M_wait(size_t k) {
+      std::unique_lock<std::mutex> lock(M_mtx);
+      M_cv.wait(lock, [&] { return M_buf[k].full; });
+      return M_buf[k];
+    }
+
+  public:
+    static bool constexpr refills = true;
+    prefetching_reader():
+      M_buf(new buffer[2]), M_producer([this] { M_produce(); }) {}
+    prefetching_reader(prefetching_reader const&) = delete;
+    ~prefetching_reader() {
+      // waits for the fread in progress, if any
+      {
+        std::lock_guard<std::mutex> lock(M_mtx);
+        M_stop = true;
+      }
+      M_cv.notify_all();
+      M_producer.join();
     }
 
+    void read(char*& pos, char*& endpos) {
+      buffer& cur = M_wait(M_cur);
+      pos = cur.data + front;
+      endpos = pos + cur.len;
+      *endpos = 0;
+      M_eof = (cur.len == 0);
+    }
+    void reread(char*& pos, char*& endpos) {
+      size_t len = endpos - pos;
+      if (M_eof || len > front) return;
+      buffer& next = M_wait(M_cur ^ 1);
+      char* tmp = next.data + front;
+      memcpy(tmp - len, pos, len);
+      pos = tmp - len;
+      endpos = tmp + next.len;
+      *endpos = 0;
+      M_eof = (next.len == 0);
+      {
+        std::lock_guard<std::mutex> lock(M_mtx);
+        M_buf[M_cur].full = false;
+      }
+      M_cv.notify_all();
+      M_cur ^= 1;
+    }
+  };
+
+  class mapped_reader {
+    // The whole stdin at once.  A regular file is mmapped and followed
+    // by zero-filled pages, so that *endpos == 0 serves as the sentinel
+    // and SIMD loads may overrun; otherwise (pipes, ttys) stdin is read
+    // up to EOF into a heap buffer with the same layout.  Either way,
+    // tokens stay valid as long as the reader lives.
+    char* head = nullptr;
+    size_t capacity = 0;
+    bool mapped = false;
+
+    bool M_map_stdin() {
+      struct stat st;
+      if (fstat(0, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size == 0)
+        return false;
+      size_t len = st.st_size;
+      size_t page = sysconf(_SC_PAGESIZE);
+      capacity = (len + margin + page-1) / page * page;
+      void* p = mmap(nullptr, capacity, PROT_READ,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if (p == MAP_FAILED) return false;
+      if (mmap(p, len, PROT_READ, MAP_PRIVATE | MAP_FIXED | MAP_POPULATE, 0, 0)
+          == MAP_FAILED) {
+        munmap(p, capacity);
+        return false;
+      }
+      madvise(p, len, MADV_SEQUENTIAL);
+      head = static_cast<char*>(p);
+      capacity = len;
+      return mapped = true;
+    }
+
+    void M_read_stdin() {
+      size_t len = 0;
+      capacity = buf_size;
+      head = static_cast<char*>(malloc(capacity + margin));
+      if (!head) throw std::bad_alloc();
+      while (size_t k = fread(head + len, 1, capacity - len, stdin)) {
+        len += k;
+        if (len < capacity) continue;
+        capacity *= 2;
+        char* tmp = static_cast<char*>(realloc(head, capacity + margin));
+        if (!tmp) throw std::bad_alloc();  // head is freed by the destructor
+        head = tmp;
+      }
+      memset(head + len, 0, margin);
+      capacity = len;
+    }
+
+  public:
+    static bool constexpr refills = false;
+    mapped_reader() = default;
+    mapped_reader(mapped_reader const&) = delete;
+    ~mapped_reader() {
+      if (mapped) munmap(head, capacity + margin);
+      else free(head);
+    }
+
+    bool is_mapped() const { return mapped; }
+
+    void read(char*& pos, char*& endpos) {
+      if (!M_map_stdin()) M_read_stdin();
+      pos = head;
+      endpos = head + capacity;
+    }
+    void reread(char*&, char*&) {}
+  };
+
+  template <typename Source = stdio_reader, typename DigitPolicy = auto_digits>
+  class basic_scanner {
+    Source src;
+    char* pos = nullptr;
+    char* endpos = nullptr;
+
+    void M_read_from_stdin() { src.read(pos, endpos); }
+    void M_reread_from_stdin() { src.reread(pos, endpos); }
+
+    void M_reserve(size_t len) {
+      // makes [pos, pos+len) readable unless EOF; the check vanishes for
+      // sources without refills.
+      if (!Source::refills) return;
+      if (__builtin_expect(endpos <= pos + len, 0)) M_reread_from_stdin();
+    }
+
+    template <typename Policy, typename Integral>
+    void M_scan(Integral& x) {
+      M_reserve(Policy::lookahead);
+      pos = Policy::parse(pos, x);
+      pos += (pos < endpos);
+    }
+
+  public:
+    basic_scanner() { M_read_from_stdin(); }
+    basic_scanner(basic_scanner const&) = delete;
+
+    Source const& source() const { return src; }
+
     template <typename Integral,
               typename enable_if_integral<Integral>::type* = nullptr>
-    // Use scan_parallel(x) only when x may be too large (about 10^12).
-    // Otherwise, even when x <= 10^9, scan_serial(x) may be faster.
-    void scan(Integral& x) { scan_serial(x); }
+    void scan_serial(Integral& x) { M_scan<serial_digits>(x); }
+
+    template <typename Integral,
+              typename enable_if_integral<Integral>::type* = nullptr>
+    void scan_parallel(Integral& x) { M_scan<swar_digits>(x); }
+
+    template <typename Integral,
+              typename enable_if_integral<Integral>::type* = nullptr>
+    void scan_simd(Integral& x) { M_scan<simd_digits>(x); }
+
+    template <typename Integral,
+              typename enable_if_integral<Integral>::type* = nullptr>
+    void scan(Integral& x) { M_scan<DigitPolicy>(x); }
+
+    void scan(double& x) {
+      M_reserve(float_chars);
+      pos = parse_double(pos, endpos, x);
+      pos += (pos < endpos);
+    }
+
+    template <typename Integral,
+              typename enable_if_integral<Integral>::type* = nullptr>
+    size_t scan_n(Integral* out, size_t n) {
+      // Reads up to n integers separated by any whitespace, and returns
+      // how many were read (less than n only at EOF).  Token boundaries
+      // of a whole window are found at once by token_mask(); digits are
+      // converted sixteen at a time.
+      size_t i = 0;
+      while (i < n) {
+        // any token starting in the window ends inside the buffer
+        M_reserve(window_size + int_digits + 1);
+        if (pos >= endpos) break;
+        scan_window(pos, endpos, out, i, n);
+      }
+      return i;
+    }
 
     void scan_serial(std::string& s) {
       // until first whitespace
       s = "";
-      do {
+      while (true) {
         char* startpos = pos;
         while (*pos > ' ') ++pos;
-        s += std::string(startpos, pos);
-        if (*pos != 0) {
+        s.append(startpos, pos);
+        if (pos < endpos) {
           ++pos;  // skip the space
           break;
         }
         M_reread_from_stdin();
-      } while (true);
+        if (pos >= endpos) break;
+      }
     }
 
     void scan(std::string& s) { scan_serial(s); }
+
+    // The following need the whole input at once.
+
+    std::string_view token() {
+      // until first whitespace; an empty view at EOF
+      static_assert(!Source::refills, "token() needs a source without refills");
+      while (pos < endpos && *pos <= ' ') ++pos;
+      char* startpos = pos;
+      while (*pos > ' ') ++pos;
+      std::string_view res(startpos, pos - startpos);
+      pos += (pos < endpos);
+      return res;
+    }
+
+    template <typename Integral,
+              typename enable_if_integral<Integral>::type* = nullptr>
+    size_t scan_n_parallel(Integral* out, size_t n, size_t threads = 0) {
+      // Same as scan_n(out, n), with the rest of the input split at
+      // whitespace into chunks, one per thread.  Tokens are counted per
+      // chunk first, so that each thread knows where in out to write.
+      static_assert(!Source::refills, "scan_n_parallel() needs a source without refills");
+      if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+      std::vector<char*> bound(threads+1, endpos);
+      bound[0] = pos;
+      for (size_t k = 1; k < threads; ++k) {
+        char* b = std::max(bound[k-1], pos + (endpos-pos) / threads * k);
+        while (*b > ' ') ++b;  // chunks end with whitespace (or *endpos)
+        bound[k] = b;
+      }
+
+      std::vector<size_t> offset(threads+1, 0);
+      std::vector<char*> last(threads, nullptr);
+      auto run = [&](auto fn) {
+        std::vector<std::thread> ths;
+        for (size_t k = 1; k < threads; ++k) ths.emplace_back(fn, k);
+        fn(0);
+        for (auto& th: ths) th.join();
+      };
+      run([&](size_t k) { offset[k+1] = count_tokens(bound[k], bound[k+1]); });
+      for (size_t k = 0; k < threads; ++k) offset[k+1] += offset[k];
+      run([&](size_t k) {
+        if (offset[k] >= n) return;
+        char* p = bound[k];
+        size_t i = offset[k];
+        size_t m = std::min(offset[k+1], n);
+        while (i < m && p < bound[k+1]) scan_window(p, bound[k+1], out, i, m);
+        last[k] = p;
+      });
+
+      size_t res = std::min(offset[threads], n);
+      for (size_t k = threads; k--;) {
+        if (!last[k]) continue;
+        pos = last[k];
+        break;
+      }
+      return res;
+    }
+
+    template <typename Integral,
+              typename enable_if_integral<Integral>::type* = nullptr>
+    std::vector<Integral> scan_vector(size_t n, size_t threads = 0) {
+      std::vector<Integral> res(n);
+      res.resize(scan_n_parallel(res.data(), n, threads));
+      return res;
+    }
   };
 
-  class printer {
-    char* pos = outbuf;
+  using scanner = basic_scanner<stdio_reader>;
+  using prefetching_scanner = basic_scanner<prefetching_reader>;
+  using mapped_scanner = basic_scanner<mapped_reader>;
 
-    void M_flush_stdout() {
+  class stdio_writer {
+    // Flushes outbuf through stdio.
+  public:
+    char* buffer() const { return outbuf; }
+    size_t capacity() const { return buf_size; }
+    char* flush(char* pos) {
+      fwrite(outbuf, 1, pos-outbuf, stdout);
+      return outbuf;
+    }
+    char* flush(char* pos, char const* s, size_t len) {
       fwrite(outbuf, 1, pos-outbuf, stdout);
-      pos = outbuf;
+      fwrite(s, 1, len, stdout);
+      return outbuf;
     }
+  };
+
+  inline void write_all(int fd, iovec* iov, int cnt) {
+    // writev() until everything is written, resuming partial writes
+    while (cnt > 0) {
+      ssize_t k = writev(fd, iov, cnt);
+      if (k < 0) {
+        if (errno == EINTR) continue;
+        return;
+      }
+      for (; cnt > 0 && size_t(k) >= iov->iov_len; ++iov, --cnt)
+        k -= iov->iov_len;
+      if (cnt == 0) break;
+      iov->iov_base = static_cast<char*>(iov->iov_base) + k;
+      iov->iov_len -= k;
+    }
+  }
+
+  class fd_buffer {
+    // An anonymous mapping of at least size + margin bytes, backed by
+    // huge pages if requested and available.
+    char* M_head = nullptr;
+    size_t M_size = 0;
 
   public:
-    printer() = default;
-    ~printer() { M_flush_stdout(); }
+    fd_buffer() = default;
+    fd_buffer(size_t size, bool huge) {
+      size_t page = sysconf(_SC_PAGESIZE);
+      size_t huge_page = size_t(1) << 21;
+      void* p = MAP_FAILED;
+      if (huge) {
+        M_size = (size + margin + huge_page-1) / huge_page * huge_page;
+        p = mmap(nullptr, M_size, PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+      }
+      if (p == MAP_FAILED) {
+        if (!huge) M_size = (size + margin + page-1) / page * page;
+        p = mmap(nullptr, M_size, PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED)
+          throw std::system_error(errno, std::generic_category(), "fd_buffer: mmap");
+        if (huge) madvise(p, M_size, MADV_HUGEPAGE);  // transparent ones
+      }
+      M_head = static_cast<char*>(p);
+    }
+    fd_buffer(fd_buffer const&) = delete;
+    fd_buffer& operator =(fd_buffer&& other) {
+      std::swap(M_head, other.M_head);
+      std::swap(M_size, other.M_size);
+      return *this;
+    }
+    ~fd_buffer() { if (M_head) munmap(M_head, M_size); }
+
+    char* data() const { return M_head; }
+  };
+
+  class fd_writer {
+    // Writes with write(2)/writev(2) to fd directly, bypassing stdio and
+    // its copy.  Do not mix with stdio output to the same fd.
+    int M_fd;
+    size_t M_capacity;
+    fd_buffer M_buf;
+
+  public:
+    fd_writer(size_t size = buf_size, bool huge = false, int fd = 1):
+      M_fd(fd), M_capacity(size), M_buf(size, huge) {}
+
+    char* buffer() const { return M_buf.data(); }
+    size_t capacity() const { return M_capacity; }
+    char* flush(char* pos) {
+      iovec iov[] = {{M_buf.data(), size_t(pos - M_buf.data())}};
+      write_all(M_fd, iov, 1);
+      return M_buf.data();
+    }
+    char* flush(char* pos, char const* s, size_t len) {
+      iovec iov[] = {
+        {M_buf.data(), size_t(pos - M_buf.data())},
+        {const_cast<char*>(s), len},
+      };
+      write_all(M_fd, iov, 2);
+      return M_buf.data();
+    }
+  };
+
+  class async_fd_writer {
+    // Two alternating buffers: flush() hands the filled one to a flush
+    // thread and returns the other one, waiting only if the thread is
+    // still writing it out.
+    int M_fd;
+    size_t M_capacity;
+    fd_buffer M_buf[2];
+    size_t M_cur = 0;
+    size_t M_pending = 0;  // bytes of M_buf[M_cur^1] to write
+    bool M_busy = false;
+    bool M_stop = false;
+    std::mutex M_mtx;
+    std::condition_variable M_cv;
+    std::thread M_flusher;
+
+    void M_run() {
+      while (true) {
+        std::unique_lock<std::mutex> lock(M_mtx);
+        M_cv.wait(lock, [&] { return M_stop || M_busy; });
+        if (!M_busy) return;
+        iovec iov[] = {{M_buf[M_cur^1].data(), M_pending}};
+        lock.unlock();
+        write_all(M_fd, iov, 1);
+        lock.lock();
+        M_busy = false;
+        M_cv.notify_all();
+      }
+    }
+
+    void M_wait() {
+      std::unique_lock<std::mutex> lock(M_mtx);
+      M_cv.wait(lock, [&] { return !M_busy; });
+    }
+
+  public:
+    async_fd_writer(size_t size = buf_size, bool huge = false, int fd = 1):
+      M_fd(fd), M_capacity(size)
+    {
+      M_buf[0] = fd_buffer(size, huge);
+      M_buf[1] = fd_buffer(size, huge);
+      M_flusher = std::thread([this] { M_run(); });
+    }
+    async_fd_writer(async_fd_writer const&) = delete;
+    ~async_fd_writer() {
+      {
+        std::unique_lock<std::mutex> lock(M_mtx);
+        M_cv.wait(lock, [&] { return !M_busy; });
+        M_stop = true;
+      }
+      M_cv.notify_all();
+      M_flusher.join();
+    }
+
+    char* buffer() const { return M_buf[M_cur].data(); }
+    size_t capacity() const { return M_capacity; }
+    char* flush(char* pos) {
+      M_wait();
+      {
+        std::lock_guard<std::mutex> lock(M_mtx);
+        M_pending = pos - M_buf[M_cur].data();
+        M_cur ^= 1;
+        M_busy = true;
+      }
+      M_cv.notify_all();
+      return M_buf[M_cur].data();
+    }
+    char* flush(char* pos, char const* s, size_t len) {
+      M_wait();
+      iovec iov[] = {
+        {M_buf[M_cur].data(), size_t(pos - M_buf[M_cur].data())},
+        {const_cast<char*>(s), len},
+      };
+      write_all(M_fd, iov, 2);
+      return M_buf[M_cur].data();
+    }
+  };
+
+  template <typename Writer>
+  class basic_printer {
+    Writer writer;
+    char* head = writer.buffer();
+    char* last = head + writer.capacity();
+    char* pos = head;
+
+    void M_flush_stdout() {
+      head = writer.flush(pos);
+      last = head + writer.capacity();
+      pos = head;
+    }
+
+    template <typename Integral>
+    void M_write_integer(Integral x) {
+      typename std::make_unsigned<Integral>::type y = x;
+      if (x < 0) {
+        *pos++ = '-';
+        y = -y;
+      }
+      int len = count_digits(y);
+      write_digits(pos, y, len);
+      pos += len;
+    }
+
+  public:
+    basic_printer() = default;
+    template <typename... Args>
+    explicit basic_printer(Args&&... args):
+      writer(std::forward<Args>(args)...) {}
+    basic_printer(basic_printer const&) = delete;
+    ~basic_printer() { M_flush_stdout(); }
 
     void print(char c) {
-      if (__builtin_expect(pos + 1 >= outbuf + buf_size, 0)) M_flush_stdout();
+      if (__builtin_expect(pos + 1 >= last, 0)) M_flush_stdout();
       *pos++ = c;
     }
 
     template <size_t N>
     void print(char const(&s)[N]) {
-      if (__builtin_expect(pos + N >= outbuf + buf_size, 0)) M_flush_stdout();
+      if (__builtin_expect(pos + N >= last, 0)) M_flush_stdout();
       memcpy(pos, s, N-1);
       pos += N-1;
     }
@@ -154,14 +902,26 @@ namespace fast {
     void print(char const* s) {
       while (*s != 0) {
         *pos++ = *s++;
-        if (pos == outbuf + buf_size) M_flush_stdout();
+        if (pos == last) M_flush_stdout();
       }
     }
 
+    void print(std::string_view s) {
+      if (pos + s.size() < last) {
+        memcpy(pos, s.data(), s.size());
+        pos += s.size();
+        return;
+      }
+      // too long to buffer; written along with the buffer at once
+      head = writer.flush(pos, s.data(), s.size());
+      last = head + writer.capacity();
+      pos = head;
+    }
+
     template <typename Integral,
               typename enable_if_integral<Integral>::type* = nullptr>
-    void print(Integral x) {
-      if (__builtin_expect(pos + int_digits >= outbuf + buf_size, 0))
+    void print_serial(Integral x) {
+      if (__builtin_expect(pos + int_digits >= last, 0))
         M_flush_stdout();
       if (x == 0) {
         *pos++ = '0';
@@ -191,9 +951,60 @@ namespace fast {
       pos += len;
     }
 
+    template <typename Integral,
+              typename enable_if_integral<Integral>::type* = nullptr>
+    void print_table(Integral x) {
+      if (__builtin_expect(pos + int_digits >= last, 0))
+        M_flush_stdout();
+      M_write_integer(x);
+    }
+
+    template <typename Integral,
+              typename enable_if_integral<Integral>::type* = nullptr>
+    void print(Integral x) { print_table(x); }
+
+    void print(double x) {
+      // shortest representation that reads back as x
+      if (__builtin_expect(pos + shortest_chars >= last, 0))
+        M_flush_stdout();
+      pos = format_shortest(pos, last, x);
+    }
+
+    void print(double x, int precision) {
+      // fixed, with precision digits after the decimal point
+      if (__builtin_expect(pos + fixed_chars + precision >= last, 0))
+        M_flush_stdout();
+      if (char* e = format_fixed(pos, last, x, precision)) {
+        pos = e;
+        return;
+      }
+      // longer than the whole buffer; formatted aside and written at once
+      std::vector<char> tmp(fixed_chars + precision);
+      char* e = format_fixed(tmp.data(), tmp.data() + tmp.size(), x, precision);
+      print(std::string_view(tmp.data(), e - tmp.data()));
+    }
+
+    template <typename Integral,
+              typename enable_if_integral<Integral>::type* = nullptr>
+    void print_n(Integral const* a, size_t n, char sep = ' ') {
+      // a[0], sep, a[1], sep, ..., a[n-1] (without trailing sep)
+      if (n == 0) return;
+      for (size_t i = 0; i < n; ++i) {
+        if (__builtin_expect(pos + int_digits + 1 >= last, 0))
+          M_flush_stdout();
+        M_write_integer(a[i]);
+        *pos++ = sep;
+      }
+      --pos;
+    }
+
     template <typename Tp>
     void println(Tp const& x) { print(x), print('\n'); }
   };
+
+  using printer = basic_printer<stdio_writer>;
+  using fd_printer = basic_printer<fd_writer>;
+  using async_printer = basic_printer<async_fd_writer>;
 } // fast::
 
 fast::scanner cin;
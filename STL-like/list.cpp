@@ -89,6 +89,24 @@ namespace stl_like
       List_node_base* M_base()
       { return this; }
     };
+
+    inline void
+    List_node_base::M_hook(List_node_base* const position) noexcept
+    {
+      this->M_next = position;
+      this->M_prev = position->M_prev;
+      position->M_prev->M_next = this;
+      position->M_prev = this;
+    }
+
+    inline void
+    List_node_base::M_unhook() noexcept
+    {
+      List_node_base* const next_node = this->M_next;
+      List_node_base* const prev_node = this->M_prev;
+      prev_node->M_next = next_node;
+      next_node->M_prev = prev_node;
+    }
   }  // namespace detail
 
   /// An actual node in the %list.
@@ -461,8 +479,8 @@ namespace stl_like
     typedef Tp                                          value_type;
     typedef typename Tp_alloc_traits::pointer           pointer;
     typedef typename Tp_alloc_traits::const_pointer     const_pointer;
-    typedef typename Tp_alloc_traits::reference         reference;
-    typedef typename Tp_alloc_traits::const_reference   const_reference;
+    typedef value_type&                                 reference;
+    typedef const value_type&                           const_reference;
     typedef List_iterator<Tp>                           iterator;
     typedef List_const_iterator<Tp>                     const_iterator;
     typedef std::reverse_iterator<const_iterator>       const_reverse_iterator;
@@ -1467,6 +1485,20 @@ namespace stl_like
     }
   };
 
+  template <typename Tp, typename Alloc>
+  void
+  List_base<Tp, Alloc>::M_clear() noexcept
+  {
+    typedef List_node<Tp> Node;
+    detail::List_node_base* cur = M_impl.M_node.M_next;
+    while (cur != &M_impl.M_node) {
+      Node* tmp = static_cast<Node*>(cur);
+      cur = tmp->M_next;
+      Node_alloc_traits::destroy(M_get_Node_allocator(), tmp->M_valptr());
+      M_put_node(tmp);
+    }
+  }
+
 #if __cpp_deduction_guides >= 201606
   template<
     typename InputIterator,
@@ -1596,4 +1628,5 @@ int main() {
 
   for (int a: x)
     std::cout << a << std::endl;
+  return 0;
 }
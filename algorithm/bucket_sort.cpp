@@ -1,19 +1,53 @@
 template <typename ForwardIt, typename Hash = std::hash<typename ForwardIt::value_type>>
 void bucket_sort(ForwardIt first, ForwardIt last, Hash hf = Hash()) {
-  using value_type = typename ForwardIt::value_type;
-  size_t size = 0;
+  // Counting sort by hf(x), stable.  The counts (growing up to the largest
+  // hash) are taken in one pass, and the elements are scattered by their
+  // prefix sums into one buffer and moved back in the next.
+  using value_type = typename std::iterator_traits<ForwardIt>::value_type;
+  std::vector<size_t> num;
+  size_t n = 0;
+  for (auto it = first; it != last; ++it, ++n) {
+    size_t i = hf(*it);
+    if (i >= num.size()) num.resize(i+1);
+    ++num[i];
+  }
+  {
+    size_t tmp = 0;
+    for (auto& x: num) std::swap(tmp, x += tmp);
+  }
+
+  std::vector<value_type> work(n);
   for (auto it = first; it != last; ++it)
-    size = std::max(size, hf(*it)+1);
+    work[num[hf(*it)]++] = std::move(*it);
+  std::move(work.begin(), work.end(), first);
+}
 
-  std::vector<std::queue<value_type>> bucket(size);
+template <typename RandomIt, typename Hash = std::hash<typename RandomIt::value_type>>
+void inplace_bucket_sort(RandomIt first, RandomIt last, Hash hf = Hash()) {
+  // Not stable, but with O(max hash) extra space.  Each element is
+  // swapped straight into the next free place of its bucket, following
+  // the cycles of the permutation.
+  std::vector<size_t> head;
   for (auto it = first; it != last; ++it) {
     size_t i = hf(*it);
-    bucket[i].push(std::move(*it));
+    if (i >= head.size()) head.resize(i+1);
+    ++head[i];
+  }
+  std::vector<size_t> tail(head.size());
+  {
+    size_t tmp = 0;
+    for (size_t i = 0; i < head.size(); ++i) {
+      std::swap(tmp, head[i] += tmp);
+      tail[i] = tmp;
+    }
   }
 
-  for (size_t i = 0; i < size; ++i)
-    while (!bucket[i].empty()) {
-      *first++ = std::move(bucket[i].front());
-      bucket[i].pop();
+  for (size_t i = 0; i < head.size(); ++i) {
+    while (head[i] < tail[i]) {
+      size_t j;
+      while ((j = hf(first[head[i]])) != i)
+        std::iter_swap(first + head[i], first + head[j]++);
+      ++head[i];
     }
+  }
 }
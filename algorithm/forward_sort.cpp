@@ -1,37 +1,189 @@
-template <typename ForwardIt>
-void forward_merge(ForwardIt first, ForwardIt mid, ForwardIt last) {
+namespace detail {
+template <typename Run, typename Merge>
+void merge_collapse(std::vector<Run>& runs, Merge merge, bool force = false) {
+  // Merges the runs on the stack until the lengths satisfy
+  // len[i-2] > len[i-1] + len[i] and len[i-1] > len[i], as timsort does,
+  // so that the merges stay balanced.  With force, merges them all.
+  auto merge_at = [&](size_t i) {
+    runs[i] = merge(runs[i], runs[i+1]);
+    runs.erase(runs.begin() + i + 1);
+  };
+  while (runs.size() > 1) {
+    size_t n = runs.size();
+    if ((n >= 3 && runs[n-3].len <= runs[n-2].len + runs[n-1].len) ||
+        (n >= 4 && runs[n-4].len <= runs[n-3].len + runs[n-2].len)) {
+      merge_at((runs[n-3].len < runs[n-1].len)? n-3: n-2);
+    } else if (force || runs[n-2].len <= runs[n-1].len) {
+      merge_at(n-2);
+    } else {
+      break;
+    }
+  }
+}
+
+template <typename ForwardIt, typename Compare, typename Buffer>
+void forward_merge(ForwardIt first, ForwardIt mid, ForwardIt last,
+                   Compare comp, Buffer& buf) {
+  // Merges sorted [first, mid) and [mid, last) stably.  Only the part of
+  // [first, mid) that is not already in place is moved out to buf; the
+  // output never overtakes the unread part of [mid, last).
+  while (first != mid && !comp(*mid, *first)) ++first;
+  if (first == mid) return;
+  buf.clear();
+  buf.insert(buf.end(), std::make_move_iterator(first), std::make_move_iterator(mid));
+  auto it = buf.begin();
+  while (it != buf.end() && mid != last) {
+    if (comp(*mid, *it)) *first++ = std::move(*mid++);
+    else *first++ = std::move(*it++);
+  }
+  std::move(it, buf.end(), first);
+}
+
+template <typename ForwardIt, typename Compare>
+void forward_sort(ForwardIt first, ForwardIt last, Compare comp, ...) {
+  // Natural runs are found from left to right, extended to at least
+  // `small' elements by insertion, and merged on a stack.  All the
+  // merges share one buffer.
   using value_type = typename std::iterator_traits<ForwardIt>::value_type;
-  std::vector<value_type> left(std::make_move_iterator(first), std::make_move_iterator(mid));
-  std::vector<value_type> right(std::make_move_iterator(mid), std::make_move_iterator(last));
-  auto itl = left.begin();
-  auto itr = right.begin();
+  constexpr size_t small = 16;
+  struct run {
+    ForwardIt first, back;  // back is the last element
+    size_t len;
+  };
+
+  std::vector<value_type> buf;
+  auto merge = [&](run const& x, run const& y) -> run {
+    if (comp(*y.first, *x.back))
+      forward_merge(x.first, y.first, std::next(y.back), comp, buf);
+    return {x.first, y.back, x.len + y.len};
+  };
+
+  std::vector<run> runs;
   while (first != last) {
-    bool from_left = !(itl == left.end() || (itr != right.end() && *itr < *itl));
-    *first++ = std::move(*(from_left? itl: itr));
-    ++(from_left? itl: itr);
+    run cur{first, first, 1};
+    ForwardIt it = std::next(first);
+    for (; it != last; ++it, ++cur.len) {
+      if (!comp(*it, *cur.back)) {
+        cur.back = it;
+      } else if (cur.len < small) {
+        // inserts *it after the last element not greater than it
+        ForwardIt pos = cur.first;
+        while (!comp(*it, *pos)) ++pos;
+        std::rotate(pos, it, std::next(it));
+        cur.back = it;
+      } else {
+        break;
+      }
+    }
+    runs.push_back(cur);
+    merge_collapse(runs, merge);
+    first = it;
   }
+  merge_collapse(runs, merge, true);
 }
 
-template <typename ForwardIt>
-void forward_sort(ForwardIt first, ForwardIt last) {
-  if (first == last) return;
+template <typename ListIt, typename Compare,
+          typename Node = decltype(std::declval<ListIt&>().M_node->M_next)>
+void forward_sort(ListIt first, ListIt last, Compare comp, std::nullptr_t) {
+  // For stl_like::list, whose iterators expose M_node: the nodes are
+  // relinked, and no element is moved.  Runs are chains from head to
+  // tail whose outer links are left dangling until the end.  M_prev is
+  // kept up to date on the way, as another pass over the sorted (and so
+  // scattered) nodes would cost a cache miss each.
+  constexpr size_t small = 16;
+  auto less = [&](Node x, Node y) { return comp(*ListIt(x), *ListIt(y)); };
+  auto link = [](Node x, Node y) {
+    x->M_next = y;
+    y->M_prev = x;
+  };
+  struct run {
+    Node head, tail;
+    size_t len;
+  };
 
-  using difference_type = typename std::iterator_traits<ForwardIt>::difference_type;
-  auto next_until = [](ForwardIt it, difference_type n, ForwardIt sent) {
-    while (n-- && it != sent) ++it;
-    return it;
+  auto merge = [&](run const& x, run const& y) -> run {
+    if (!less(y.head, x.tail)) {
+      link(x.tail, y.head);
+      return {x.head, y.tail, x.len + y.len};
+    }
+    Node a = x.head, b = y.head;
+    Node ae = x.tail->M_next = nullptr, be = y.tail->M_next = nullptr;
+    Node head;
+    if (less(b, a)) {
+      head = b;
+      b = b->M_next;
+    } else {
+      head = a;
+      a = a->M_next;
+    }
+    Node tail = head;
+    while (a != ae && b != be) {
+      if (less(b, a)) {
+        link(tail, b);
+        tail = b;
+        b = b->M_next;
+      } else {
+        link(tail, a);
+        tail = a;
+        a = a->M_next;
+      }
+    }
+    if (a != ae) {
+      link(tail, a);
+      tail = x.tail;
+    } else {
+      link(tail, b);
+      tail = y.tail;
+    }
+    return {head, tail, x.len + y.len};
   };
-  for (difference_type width = 1; true; width <<= 1) {
-    auto first0 = first;
-    while (first0 != last) {
-      auto mid0 = next_until(first0, width, last);
-      auto last0 = next_until(mid0, width, last);
-      if (mid0 == last0) {
-        if (first == first0) return;
+
+  Node before = first.M_node->M_prev;
+  Node end = last.M_node;
+  std::vector<run> runs;
+  for (Node cur = first.M_node; cur != end;) {
+    run r{cur, cur, 1};
+    cur = cur->M_next;
+    for (; cur != end; ++r.len) {
+      Node next = cur->M_next;
+      if (!less(cur, r.tail)) {
+        r.tail = cur;
+      } else if (r.len < small) {
+        // takes cur out, and puts it after the last node not greater
+        link(cur->M_prev, next);
+        if (less(cur, r.head)) {
+          link(cur, r.head);
+          r.head = cur;
+        } else {
+          Node pos = r.head;
+          while (!less(cur, pos->M_next)) pos = pos->M_next;
+          link(cur, pos->M_next);
+          link(pos, cur);
+        }
+      } else {
         break;
       }
-      my_merge(first0, mid0, last0);
-      first0 = last0;
+      cur = next;
     }
+    runs.push_back(r);
+    merge_collapse(runs, merge);
   }
+  if (runs.empty()) return;
+  merge_collapse(runs, merge, true);
+  link(before, runs[0].head);
+  link(runs[0].tail, end);
+}
+}  // detail::
+
+template <typename ForwardIt, typename Compare = std::less<>>
+void forward_merge(ForwardIt first, ForwardIt mid, ForwardIt last, Compare comp = Compare()) {
+  using value_type = typename std::iterator_traits<ForwardIt>::value_type;
+  std::vector<value_type> buf;
+  detail::forward_merge(first, mid, last, comp, buf);
+}
+
+template <typename ForwardIt, typename Compare = std::less<>>
+void forward_sort(ForwardIt first, ForwardIt last, Compare comp = Compare()) {
+  // Stable.  The nullptr picks the node-relinking version if applicable.
+  detail::forward_sort(first, last, comp, nullptr);
 }
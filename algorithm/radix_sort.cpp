@@ -1,42 +1,320 @@
-template <class BidirIt>
-void radix_sort(BidirIt first, BidirIt last) {
-  using value_type = typename BidirIt::value_type;
-  constexpr int shift = 8;
-  constexpr int max_exp = sizeof(value_type);
-  constexpr size_t size = 1 << shift;
-  constexpr size_t mask = size-1;
-  std::vector<value_type> work(std::distance(first, last));
-  for (int i = 0, cs = 0; i < max_exp; ++i) {
-    size_t num[size] = {};
+namespace detail {
+template <typename Tp, typename = void>
+struct radix_key {
+  // integers, with the sign bit flipped so that the unsigned order agrees
+  using type = typename std::make_unsigned<Tp>::type;
+  static constexpr size_t width = std::numeric_limits<type>::digits;
+  static type get(Tp const& x) {
+    constexpr type flip =
+      std::is_signed<Tp>::value? type(1) << (width-1): 0;
+    return type(x) ^ flip;
+  }
+};
+
+template <typename Tp>
+struct radix_key<Tp, typename std::enable_if<std::is_floating_point<Tp>::value>::type> {
+  // IEEE 754 binary32/64: negatives have all bits flipped and the others
+  // the sign bit only.  -0.0 comes before +0.0, and NaNs at either end
+  // by their sign.
+  static_assert(sizeof(Tp) == 4 || sizeof(Tp) == 8, "binary32/64 only");
+  using type = typename std::conditional<(sizeof(Tp) == 4), uint32_t, uint64_t>::type;
+  static constexpr size_t width = std::numeric_limits<type>::digits;
+  static type get(Tp const& x) {
+    type u;
+    memcpy(&u, &x, sizeof u);
+    type sign = type(1) << (width-1);
+    return u ^ ((u & sign)? ~type(0): sign);
+  }
+};
+
+template <typename Tp, typename Up>
+struct radix_key<std::pair<Tp, Up>> {
+  // ordered by first only, keeping the order of equal keys
+  using type = typename radix_key<Tp>::type;
+  static constexpr size_t width = radix_key<Tp>::width;
+  static type get(std::pair<Tp, Up> const& x) {
+    return radix_key<Tp>::get(x.first);
+  }
+};
+
+template <size_t Bits, class RandomIt, class Key>
+void radix_histogram(RandomIt first, RandomIt last, size_t* num, size_t max_exp, Key key_of) {
+  // adds the counts of the lowest max_exp digits to num[i << Bits | d]
+  constexpr size_t mask = (size_t(1) << Bits) - 1;
+  for (RandomIt it = first; it != last; ++it) {
+    auto key = key_of(*it);
+    for (size_t i = 0; i < max_exp; ++i)
+      ++num[i << Bits | (key >> (i*Bits) & mask)];
+  }
+}
+
+template <size_t Bits, class RandomIt, class WorkIt, class Key>
+bool radix_sort_lsd(RandomIt first, RandomIt last, WorkIt work, size_t max_exp, Key key_of) {
+  // Sorts [first, last) by the lowest max_exp digits of key_of(x), going
+  // back and forth between it and work (of the same length).  Returns
+  // whether the result ended up in work.
+  constexpr size_t size = size_t(1) << Bits;
+  auto digit = [&key_of](auto const& x, size_t cs) -> size_t {
+    return key_of(x) >> cs & (size-1);
+  };
+
+  size_t n = std::distance(first, last);
+  if (n <= 1) return false;
+
+  std::vector<size_t> num(max_exp * size);
+  radix_histogram<Bits>(first, last, num.data(), max_exp, key_of);
 
-    for (BidirIt it = first; it != last; ++it)
-      ++num[*it >> cs & mask];
+  bool in_work = false;
+  for (size_t i = 0, cs = 0; i < max_exp; ++i, cs += Bits) {
+    size_t* cnt = num.data() + i*size;
+    if (cnt[digit(*first, cs)] == n) continue;
     {
       size_t tmp = 0;
       for (size_t j = 0; j < size; ++j)
-        std::swap(tmp, num[j] += tmp);
+        std::swap(tmp, cnt[j] += tmp);
     }
-    for (BidirIt it = first; it != last; ++it)
-      work[num[*it >> cs & mask]++] = *it;
-    {
-      size_t j = 0;
-      for (BidirIt it = first; it != last; ++it)
-        *it = work[j++];
+    if (!in_work) {
+      for (RandomIt it = first; it != last; ++it)
+        work[cnt[digit(*it, cs)]++] = std::move(*it);
+    } else {
+      for (WorkIt it = work, e = work+n; it != e; ++it)
+        first[cnt[digit(*it, cs)]++] = std::move(*it);
     }
-    cs += shift;
+    in_work = !in_work;
   }
-  if (!std::is_signed<value_type>::value) return;
+  return in_work;
+}
 
-  BidirIt mid = last;
-  for (BidirIt it = last; it-- != first;)
-    if (*it >= 0) {
-      mid = ++it;
+template <class RandomIt, class KeyFn>
+void multikey_quicksort(RandomIt first, RandomIt last, size_t depth, KeyFn const& key_fn) {
+  // Bentley--Sedgewick three-way partitioning on the depth-th byte, for
+  // records whose keys agree on the first depth bytes.  -1 stands for
+  // the end of a key.
+  auto byte = [&](auto const& x) -> int {
+    std::string_view s = key_fn(x);
+    return (depth < s.size())? static_cast<unsigned char>(s[depth]): -1;
+  };
+  while (last - first > 8) {
+    RandomIt mid = first + (last - first) / 2;
+    int a = byte(*first), b = byte(*mid), c = byte(*(last-1));
+    int v = std::max(std::min(a, b), std::min(std::max(a, b), c));
+    // [first, lt) < v, [lt, it) == v, [gt, last) > v
+    RandomIt lt = first, it = first, gt = last;
+    while (it != gt) {
+      int d = byte(*it);
+      if (d < v) std::iter_swap(lt++, it++);
+      else if (d > v) std::iter_swap(it, --gt);
+      else ++it;
+    }
+    // The largest part is taken by the loop, and the other two (at most
+    // half each) by recursion, so that it nests O(log n) deep however
+    // long the common prefixes are.
+    ptrdiff_t nl = lt - first, ne = gt - lt, ng = last - gt;
+    if (ne >= nl && ne >= ng) {
+      multikey_quicksort(first, lt, depth, key_fn);
+      multikey_quicksort(gt, last, depth, key_fn);
+      if (v < 0) return;  // the keys in [lt, gt) have ended, and are equal
+      first = lt;
+      last = gt;
+      ++depth;
+    } else if (nl >= ng) {
+      if (v >= 0) multikey_quicksort(lt, gt, depth+1, key_fn);
+      multikey_quicksort(gt, last, depth, key_fn);
+      last = lt;
+    } else {
+      multikey_quicksort(first, lt, depth, key_fn);
+      if (v >= 0) multikey_quicksort(lt, gt, depth+1, key_fn);
+      first = gt;
+    }
+  }
+  for (RandomIt it = first; it != last; ++it)
+    for (RandomIt jt = it; jt != first; --jt) {
+      std::string_view x = key_fn(*jt), y = key_fn(*(jt-1));
+      if (!(x.substr(depth) < y.substr(depth))) break;
+      std::iter_swap(jt, jt-1);
+    }
+}
+
+template <class RandomIt, class KeyFn>
+void american_flag_sort(RandomIt first, RandomIt last, size_t depth, KeyFn const& key_fn,
+                        size_t level = 0) {
+  // In-place MSD radix sort on bytes: the records are counted into 257
+  // buckets (the end of a key, and bytes 0 to 255), and then permuted
+  // into place by following cycles.  A byte common to all the records
+  // is skipped without a pass or a new frame.  Buckets with few records,
+  // or below max_level nested frames (of some 6 KB each), are left to
+  // multikey_quicksort().
+  constexpr size_t size = 257;
+  constexpr ptrdiff_t small = 64;
+  constexpr size_t max_level = 16;
+  if (last - first <= small || level >= max_level)
+    return multikey_quicksort(first, last, depth, key_fn);
+
+  auto bucket = [&](auto const& x) -> size_t {
+    std::string_view s = key_fn(x);
+    return (depth < s.size())? 1 + static_cast<unsigned char>(s[depth]): 0;
+  };
+  size_t num[size];
+  while (true) {
+    std::fill(num, num+size, 0);
+    for (RandomIt it = first; it != last; ++it) ++num[bucket(*it)];
+    size_t b = bucket(*first);
+    if (num[b] < size_t(last - first)) break;
+    if (b == 0) return;  // all the keys have ended, and are equal
+    ++depth;
+  }
+
+  ptrdiff_t head[size], tail[size];
+  {
+    ptrdiff_t tmp = 0;
+    for (size_t j = 0; j < size; ++j) {
+      head[j] = tmp;
+      tail[j] = tmp += num[j];
+    }
+  }
+  for (size_t j = 0; j < size; ++j) {
+    while (head[j] < tail[j]) {
+      // carries the record at head[j] to its bucket until one for j comes
+      size_t k;
+      while ((k = bucket(first[head[j]])) != j)
+        std::iter_swap(first + head[j], first + head[k]++);
+      ++head[j];
+    }
+  }
+  for (size_t j = 1; j < size; ++j)
+    if (num[j] > 1)
+      american_flag_sort(first + (tail[j] - num[j]), first + tail[j], depth+1, key_fn, level+1);
+}
+
+template <size_t Bits, class RandomIt, class KeyFn>
+void radix_sort_by(RandomIt first, RandomIt last, KeyFn const& key_fn, std::false_type) {
+  using value_type = typename std::iterator_traits<RandomIt>::value_type;
+  using key_type = typename std::decay<decltype(key_fn(*first))>::type;
+  using key = radix_key<key_type>;
+  constexpr size_t max_exp = (key::width + Bits-1) / Bits;
+  auto key_of = [&key_fn](value_type const& x) { return key::get(key_fn(x)); };
+
+  std::vector<value_type> work(std::distance(first, last));
+  if (radix_sort_lsd<Bits>(first, last, work.begin(), max_exp, key_of))
+    std::move(work.begin(), work.end(), first);
+}
+
+template <size_t Bits, class RandomIt, class KeyFn>
+void radix_sort_by(RandomIt first, RandomIt last, KeyFn const& key_fn, std::true_type) {
+  american_flag_sort(first, last, 0, key_fn);
+}
+}  // detail::
+
+template <size_t Bits = 8, class RandomIt, class KeyFn>
+void radix_sort_by(RandomIt first, RandomIt last, KeyFn key_fn) {
+  // Sorts the records by key_fn(x), which is either
+  // - integral, floating-point or pair<integral, T>: LSD radix sort on
+  //   Bits-bit digits, stable.  The histograms of all the digits are
+  //   built in a single pass, and a pass is skipped when every key has
+  //   the same digit there.  Passes go back and forth between the input
+  //   and a work buffer.  Signed and floating-point keys are ordered by
+  //   flipping bits (see detail::radix_key).
+  // - convertible to std::string_view: American flag sort, not stable,
+  //   in place.  key_fn should return a reference or a view into the
+  //   record rather than a new string.
+  using key_type = typename std::decay<decltype(key_fn(*first))>::type;
+  using is_string = std::integral_constant<
+    bool, std::is_convertible<key_type, std::string_view>::value>;
+  static_assert(is_string::value || (0 < Bits && Bits <= 16),
+                "digits must be 1 to 16 bits");
+  detail::radix_sort_by<Bits>(first, last, key_fn, is_string());
+}
+
+template <size_t Bits = 8, class RandomIt>
+void radix_sort(RandomIt first, RandomIt last) {
+  // by the values themselves; see radix_sort_by()
+  using value_type = typename std::iterator_traits<RandomIt>::value_type;
+  radix_sort_by<Bits>(first, last, [](value_type const& x) -> value_type const& { return x; });
+}
+
+template <size_t Bits = 8, class RandomIt>
+void parallel_radix_sort(RandomIt first, RandomIt last, size_t threads = 0) {
+  // The highest digit that is not common to all keys is done by an MSD
+  // pass: each thread counts its own chunk, and a prefix sum over (digit,
+  // thread) gives every thread disjoint places to scatter into.  Then
+  // the buckets are taken by the threads one by one and sorted by the
+  // lower digits with LSD passes, or by insertion sort if small.  The
+  // result is stable, as is radix_sort().
+  static_assert(0 < Bits && Bits <= 16, "digits must be 1 to 16 bits");
+  using value_type = typename std::iterator_traits<RandomIt>::value_type;
+  using key = detail::radix_key<value_type>;
+  constexpr size_t max_exp = (key::width + Bits-1) / Bits;
+  constexpr size_t size = size_t(1) << Bits;
+  auto key_of = [](value_type const& x) { return key::get(x); };
+  constexpr size_t mask = size-1;
+  constexpr size_t small = 64;
+
+  if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+  size_t n = std::distance(first, last);
+  if (threads == 1 || n < (size_t(1) << 16)) return radix_sort<Bits>(first, last);
+
+  auto run = [threads](auto fn) {
+    std::vector<std::thread> ths;
+    for (size_t t = 1; t < threads; ++t) ths.emplace_back(fn, t);
+    fn(0);
+    for (auto& th: ths) th.join();
+  };
+  auto chunk = [&](size_t t) { return first + n / threads * t + std::min(t, n % threads); };
+
+  std::vector<std::vector<size_t>> num(threads, std::vector<size_t>(max_exp * size));
+  run([&](size_t t) {
+    detail::radix_histogram<Bits>(chunk(t), chunk(t+1), num[t].data(), max_exp, key_of);
+  });
+
+  // the highest digit with more than one bucket in use
+  size_t top = max_exp;
+  for (size_t i = max_exp; i-- > 0;) {
+    size_t d = key::get(*first) >> (i*Bits) & mask;
+    size_t count = 0;
+    for (size_t t = 0; t < threads; ++t) count += num[t][i*size + d];
+    if (count < n) {
+      top = i;
       break;
     }
+  }
+  if (top == max_exp) return;  // all the keys are equal
+
+  std::vector<size_t> bucket(size+1);
+  {
+    size_t tmp = 0;
+    for (size_t d = 0; d < size; ++d) {
+      bucket[d] = tmp;
+      for (size_t t = 0; t < threads; ++t)
+        std::swap(tmp, num[t][top*size + d] += tmp);
+    }
+    bucket[size] = tmp;
+  }
+
+  std::vector<value_type> work(n);
+  size_t cs = top * Bits;
+  run([&](size_t t) {
+    size_t* cnt = num[t].data() + top*size;
+    for (RandomIt it = chunk(t), e = chunk(t+1); it != e; ++it)
+      work[cnt[key::get(*it) >> cs & mask]++] = std::move(*it);
+  });
 
-  if (mid == last) return;
-  ptrdiff_t len = std::distance(mid, last);
-  std::copy(first, mid, std::next(work.begin(), len));
-  std::copy(mid, last, work.begin());
-  std::copy(work.begin(), work.end(), first);
+  std::atomic<size_t> next(0);
+  run([&](size_t) {
+    for (size_t d; (d = next++) < size;) {
+      size_t lo = bucket[d], hi = bucket[d+1];
+      auto wf = work.begin() + lo, wl = work.begin() + hi;
+      if (hi - lo <= small) {
+        for (auto it = wf; it != wl; ++it) {
+          value_type x = std::move(*it);
+          auto jt = it;
+          for (; jt != wf && key::get(x) < key::get(*(jt-1)); --jt)
+            *jt = std::move(*(jt-1));
+          *jt = std::move(x);
+        }
+        std::move(wf, wl, first + lo);
+      } else if (!detail::radix_sort_lsd<Bits>(wf, wl, first + lo, top, key_of)) {
+        std::move(wf, wl, first + lo);
+      }
+    }
+  });
 }
@@ -0,0 +1,131 @@
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <cassert>
+#include <chrono>
+#include <algorithm>
+#include <array>
+#include <list>
+#include <random>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#define main dynamic_wavelet_matrix_main
+#include "dynamic_wavelet_matrix.cpp"
+#undef main
+
+// usage: ./batch [n [k]]
+// Builds the dynamic wavelet matrix of n (default: 10^6) random 20-bit
+// values by the constructor and by repeated insertion, and then inserts
+// and erases k (default: 10^5) of them at random positions, one by one
+// and by insert_batch() and erase_batch().  Prints updates/s, and checks
+// the results against each other and against std::vector at random
+// positions.
+
+using value_type = uint32_t;
+constexpr size_t bitlen = 20;
+using matrix = wavelet_matrix<value_type, bitlen>;
+
+std::mt19937 rsk(0315);
+
+double now() {
+  using namespace std::chrono;
+  return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+void check(matrix const& x, matrix const& y, std::vector<value_type> const& a) {
+  assert(x.size() == a.size());
+  assert(y.size() == a.size());
+  for (size_t q = 0; q < 10000 && !a.empty(); ++q) {
+    size_t i = rsk() % a.size();
+    assert(x[i] == a[i]);
+    assert(y[i] == a[i]);
+  }
+}
+
+void report(char const* name, size_t k, double one, double batch) {
+  fprintf(stderr, "%-8s one by one %10.0f /s  batch %10.0f /s  (%.1fx)\n",
+          name, k / one, k / batch, one / batch);
+}
+
+int main(int argc, char* argv[]) {
+  size_t n = (argc > 1)? strtoull(argv[1], nullptr, 10): 1000000;
+  size_t k = (argc > 2)? strtoull(argv[2], nullptr, 10): 100000;
+  fprintf(stderr, "n = %zu, k = %zu, bitlen = %zu\n", n, k, bitlen);
+
+  std::vector<value_type> a(n);
+  for (auto& x: a) x = rsk() % (value_type(1) << bitlen);
+
+  double start = now();
+  matrix single;
+  for (size_t i = 0; i < n; ++i) single.insert(i, a[i]);
+  double t_single = now() - start;
+
+  start = now();
+  matrix bulk(a.begin(), a.end());
+  double t_bulk = now() - start;
+  check(single, bulk, a);
+  report("build", n, t_single, t_bulk);
+
+  std::vector<std::pair<size_t, value_type>> xs(k);
+  for (auto& [t, x]: xs) {
+    t = rsk() % (n+1);
+    x = rsk() % (value_type(1) << bitlen);
+  }
+  {
+    auto sorted = xs;
+    std::stable_sort(sorted.begin(), sorted.end(), [](auto const& x, auto const& y) {
+      return x.first < y.first;
+    });
+    std::vector<value_type> b;
+    for (size_t i = 0, j = 0; i <= n; ++i) {
+      for (; j < k && sorted[j].first == i; ++j) b.push_back(sorted[j].second);
+      if (i < n) b.push_back(a[i]);
+    }
+    a.swap(b);
+  }
+
+  start = now();
+  {
+    auto sorted = xs;
+    std::stable_sort(sorted.begin(), sorted.end(), [](auto const& x, auto const& y) {
+      return x.first < y.first;
+    });
+    for (size_t j = 0; j < k; ++j) single.insert(sorted[j].first + j, sorted[j].second);
+  }
+  t_single = now() - start;
+
+  start = now();
+  bulk.insert_batch(xs);
+  double t_batch = now() - start;
+  check(single, bulk, a);
+  report("insert", k, t_single, t_batch);
+
+  std::vector<size_t> ts(a.size());
+  for (size_t i = 0; i < a.size(); ++i) ts[i] = i;
+  std::shuffle(ts.begin(), ts.end(), rsk);
+  ts.resize(k);
+  {
+    std::vector<bool> erased(a.size());
+    for (auto t: ts) erased[t] = true;
+    std::vector<value_type> b;
+    for (size_t i = 0; i < a.size(); ++i)
+      if (!erased[i]) b.push_back(a[i]);
+    a.swap(b);
+  }
+
+  start = now();
+  {
+    auto sorted = ts;
+    std::sort(sorted.begin(), sorted.end());
+    for (size_t j = k; j--;) single.erase(sorted[j]);
+  }
+  t_single = now() - start;
+
+  start = now();
+  bulk.erase_batch(ts);
+  t_batch = now() - start;
+  check(single, bulk, a);
+  report("erase", k, t_single, t_batch);
+}
@@ -0,0 +1,131 @@
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <cassert>
+#include <chrono>
+#include <algorithm>
+#include <array>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <new>
+#include <random>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <malloc.h>
+
+// The red-black tree of words and the deque of 4096-bit blocks with
+// Fenwick trees, each in its own namespace with its main renamed
+#define main rb_main
+namespace rb {
+#include "dynamic_bit_vector.cpp"
+}
+#undef main
+#define main fenwick_main
+namespace fenwick {
+#include "with_fenwick.cpp"
+}
+#undef main
+
+#include "../../DataStructure/dynamic_bit_vector.cpp"
+#include "../heap_usage.cpp"
+
+// usage: ./btree [n [method]]
+// Builds a vector of n (default: 10^6) random bits by inserting at
+// random positions, and then queries and erases them back to n/2, with
+// the B+-tree of DataStructure/dynamic_bit_vector.cpp ("btree"), the
+// red-black tree ("rb") and the Fenwick trees ("fenwick", which has no
+// select).  Prints ns/operation and the heap in bits per bit, and
+// checks the answers against each other.
+
+std::mt19937 rsk(0315);
+char const* only = nullptr;
+
+double now() {
+  using namespace std::chrono;
+  return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+struct workload {
+  std::vector<std::pair<size_t, bool>> inserts;
+  std::vector<size_t> queries, erases;
+};
+
+struct result {
+  size_t rank = 0, select = 0, access = 0;
+  std::vector<bool> bits;
+};
+
+template <typename BitVector, typename Select>
+void bench(char const* name, workload const& w, result& expected, Select select) {
+  if (only && strcmp(name, only) != 0) return;
+  size_t base = heap_cur;
+  BitVector bv;
+  result res;
+
+  double start = now();
+  for (auto [t, x]: w.inserts) bv.insert(t, x);
+  double t_insert = now() - start;
+  double bits = (heap_cur - base) * 8.0 / w.inserts.size();
+
+  start = now();
+  for (auto t: w.queries) res.rank += bv.rank(1, t);
+  double t_rank = now() - start;
+
+  size_t ones = bv.rank(1, w.inserts.size());
+  double t_select = 0;
+  if (select(bv, 1) != size_t(-2)) {
+    start = now();
+    for (auto t: w.queries) res.select += select(bv, t % ones + 1);
+    t_select = now() - start;
+  }
+
+  start = now();
+  for (auto t: w.queries) res.access += bv[t % w.inserts.size()];
+  double t_access = now() - start;
+
+  start = now();
+  for (auto t: w.erases) bv.erase(t);
+  double t_erase = now() - start;
+
+  for (size_t i = 0; i < w.inserts.size() - w.erases.size(); ++i) res.bits.push_back(bv[i]);
+  if (expected.bits.empty()) {
+    expected = res;
+  } else {
+    assert(res.rank == expected.rank);
+    assert(res.access == expected.access);
+    assert(res.bits == expected.bits);
+    if (t_select > 0) assert(res.select == expected.select);
+  }
+
+  auto ns = [](double t, size_t n) { return t / n * 1e9; };
+  fprintf(stderr, "%-8s insert %7.1f  rank %7.1f  select %7.1f  access %7.1f  erase %7.1f ns/op  %6.2f bits/bit\n",
+          name, ns(t_insert, w.inserts.size()), ns(t_rank, w.queries.size()),
+          ns(t_select, w.queries.size()), ns(t_access, w.queries.size()),
+          ns(t_erase, w.erases.size()), bits);
+}
+
+int main(int argc, char* argv[]) {
+  size_t n = (argc > 1)? strtoull(argv[1], nullptr, 10): 1000000;
+  if (argc > 2) only = argv[2];
+
+  workload w;
+  for (size_t i = 0; i < n; ++i) w.inserts.emplace_back(rsk() % (i+1), rsk() % 2);
+  for (size_t i = 0; i < n; ++i) w.queries.push_back(rsk() % (n+1));
+  for (size_t i = 0; i < n/2; ++i) w.erases.push_back(rsk() % (n-i));
+  fprintf(stderr, "n = %zu\n", n);
+
+  result expected;
+  bench<dynamic_bit_vector>("btree", w, expected, [](auto const& bv, size_t k) {
+    return bv.select1(k);
+  });
+  bench<rb::bit_vector>("rb", w, expected, [](auto const& bv, size_t k) {
+    return bv.select(1, k);
+  });
+  bench<fenwick::bit_vector>("fenwick", w, expected, [](auto const&, size_t) {
+    return size_t(-2);
+  });
+}
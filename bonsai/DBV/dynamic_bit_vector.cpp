@@ -743,4 +743,5 @@ void test2() {
 
 int main() {
   test2();
+  return 0;
 }
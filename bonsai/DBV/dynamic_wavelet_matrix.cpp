@@ -5,571 +5,11 @@
 #include <utility>
 #include <algorithm>
 #include <tuple>
+#include <array>
 
-class bit_vector {
-  class node {
-    using value_type = uintmax_t;
-    const node* neighbor(size_t dir) const {
-      const node* cur = this;
-      if (children[dir]) {
-        cur = cur->children[dir];
-        while (cur->children[!dir]) cur = cur->children[!dir];
-        return cur;
-      }
-      while (true) {
-        if (!cur->parent) return nullptr;
-        if (cur == cur->parent->children[!dir]) return cur->parent;
-        cur = cur->parent;
-      }
-    }
-    node* neighbor(size_t dir) {
-      node* cur = this;
-      if (children[dir]) {
-        cur = cur->children[dir];
-        while (cur->children[!dir]) cur = cur->children[!dir];
-        return cur;
-      }
-      while (true) {
-        if (!cur->parent) return nullptr;
-        if (cur == cur->parent->children[!dir]) return cur->parent;
-        cur = cur->parent;
-      }
-    }
-
-  public:
-    node* children[2] = {nullptr, nullptr};
-    node* parent = nullptr;
-    value_type value;
-    size_t size = 0;
-    size_t left_size = 0;
-    size_t left_one = 0;
-    enum Color {RED, BLACK} color = RED;
-    node(const value_type& x, size_t size): value(x), size(size) {}
-
-    node* successor() { return neighbor(1); }
-    const node* successor() const { return neighbor(1); }
-    node* predecessor() { return neighbor(0); }
-    const node* predecessor() const { return neighbor(0); }
-
-    const node* root() const {
-      const node* cur = this;
-      while (cur->parent) cur = cur->parent;
-      return cur;
-    }
-  };
-
-public:
-  using value_type = uintmax_t;
-
-  class iterator {
-    friend bit_vector;
-    node* nd = nullptr;
-    node* root = nullptr;
-
-    iterator(node* nd, node* root): nd(nd), root(root) {}
-  public:
-    iterator() {}
-
-    using value_type = uintmax_t;
-
-    const value_type& operator *() const { return nd->value; }
-    value_type& operator *() { return nd->value; }
-    node* operator ->() const { return nd; }
-    iterator& operator ++() {
-      nd = nd->successor();
-      return *this;
-    }
-    iterator operator ++(int) {
-      iterator tmp = *this;
-      ++(*this);
-      return tmp;
-    }
-    iterator& operator --() {
-      if (nd == nullptr) {
-        nd = root;
-        while (nd->children[1]) nd = nd->children[1];
-      } else {
-        nd = nd->predecessor();
-      }
-      return *this;
-    }
-    iterator operator --(int) {
-      iterator tmp = *this;
-      --(*this);
-      return tmp;
-    }
-
-    bool operator ==(const iterator other) const { return nd == other.nd; }
-    bool operator !=(const iterator other) const { return nd != other.nd; }
-
-    bool operator [](size_t i) const {
-      assert(i < nd->size);
-      return (nd->value) >> i & 1;
-    }
-  };
-
-private:
-  node* root = nullptr;
-  node* first = nullptr;
-  size_t size_ = 0;
-
-  bool is_red(node* nd) const { return nd && (nd->color == node::RED); }
-  size_t popcount(value_type x) const { return __builtin_popcountll(x); }
-
-  iterator begin() const { return iterator(first, root); }
-  iterator end() const { return iterator(nullptr, root); }
-
-  void rotate(node* cur, size_t dir) {
-    node* child = cur->children[!dir];
-    cur->children[!dir] = child->children[dir];
-    if (child->children[dir])
-      child->children[dir]->parent = cur;
-
-    child->parent = cur->parent;
-    if (!cur->parent) {
-      root = child;
-    } else if (cur == cur->parent->children[dir]) {
-      cur->parent->children[dir] = child;
-    } else {
-      cur->parent->children[!dir] = child;
-    }
-    child->children[dir] = cur;
-    cur->parent = child;
-
-    if (dir == 0) {
-      cur->parent->left_size += cur->left_size + cur->size;
-      cur->parent->left_one += cur->left_one + popcount(cur->value);
-    } else {
-      cur->left_size -= cur->parent->left_size + cur->parent->size;
-      cur->left_one -= cur->parent->left_one + popcount(cur->parent->value);
-    }
-  }
-
-  void insert_fixup(node* cur) {
-    while (is_red(cur->parent)) {
-      node* gparent = cur->parent->parent;
-
-      size_t uncle_dir = (cur->parent != gparent->children[1]);
-      node* uncle = gparent->children[uncle_dir];
-
-      if (is_red(uncle)) {
-        cur->parent->color = uncle->color = node::BLACK;
-        gparent->color = node::RED;
-        cur = gparent;
-        continue;
-      }
-      if (cur == cur->parent->children[uncle_dir]) {
-        cur = cur->parent;
-        rotate(cur, !uncle_dir);
-      }
-      cur->parent->color = node::BLACK;
-      cur->parent->parent->color = node::RED;
-      rotate(gparent, uncle_dir);
-    }
-    root->color = node::BLACK;
-  }
-
-  void erase_fixup(node* cur, node* parent) {
-    while (cur != root && !is_red(cur)) {
-      size_t sibling_dir = (cur == parent->children[0]);
-      node* sibling = parent->children[sibling_dir];
-
-      if (is_red(sibling)) {
-        sibling->color = node::BLACK;
-        parent->color = node::RED;
-        rotate(parent, !sibling_dir);
-        sibling = parent->children[sibling_dir];
-      }
-
-      if (sibling) {
-        if (!is_red(sibling->children[0]) && !is_red(sibling->children[1])) {
-          sibling->color = node::RED;
-          cur = parent;
-          parent = cur->parent;
-          continue;
-        }
-
-        if (!is_red(sibling->children[sibling_dir])) {
-          if (sibling->children[!sibling_dir])
-            sibling->children[!sibling_dir]->color = node::BLACK;
-
-          sibling->color = node::RED;
-          rotate(sibling, sibling_dir);
-          sibling = parent->children[sibling_dir];
-        }
-
-        sibling->color = parent->color;
-        sibling->children[sibling_dir]->color = node::BLACK;
-      }
-
-      parent->color = node::BLACK;
-      rotate(parent, !sibling_dir);
-      cur = root;
-      parent = nullptr;
-    }
-    if (cur) cur->color = node::BLACK;
-  }
-
-  void propagate_left_size(node* cur, size_t diff) {
-    while (cur->parent) {
-      if (cur == cur->parent->children[0])
-        cur->parent->left_size += diff;
-      cur = cur->parent;
-    }
-  }
-
-  void propagate_left_one(node* cur, size_t diff) {
-    while (cur->parent) {
-      if (cur == cur->parent->children[0])
-        cur->parent->left_one += diff;
-      cur = cur->parent;
-    }
-  }
-
-  node* insert(node* before_of, node* nd) {
-    assert(nd);
-
-    nd->children[0] = nd->children[1] = nullptr;
-    nd->left_size = 0;
-    nd->left_one = 0;
-    nd->color = node::RED;
-
-    if (!before_of) {
-      before_of = root;
-      if (!before_of) {
-        // empty
-        nd->color = node::BLACK;
-        nd->parent = nullptr;
-        size_ += nd->size;
-        root = first = nd;
-        return nd;
-      }
-      while (before_of->children[1]) before_of = before_of->children[1];
-      before_of->children[1] = nd;
-    } else if (before_of->children[0]) {
-      before_of = before_of->predecessor();
-      before_of->children[1] = nd;
-    } else {
-      before_of->children[0] = nd;
-      if (before_of == first) first = nd;
-    }
-
-    nd->parent = before_of;
-    size_ += nd->size;
-    propagate_left_size(nd, nd->size);
-    propagate_left_one(nd, popcount(nd->value));
-    insert_fixup(nd);
-    return nd;
-  }
-
-  node* erase(iterator it) { return erase(it.nd); }
-  node* erase(node* nd) {
-    assert(nd);
-
-    node* after = nd->successor();
-
-    size_ -= nd->size;
-    node* y = nd;
-    if (nd->children[0] && nd->children[1]) y = y->successor();
-
-    size_t left_size = nd->left_size;
-    size_t left_one = nd->left_one;
-
-    node* x = y->children[0];
-    if (!x) x = y->children[1];
-    if (x) x->parent = y->parent;
-    if (!y->parent) {
-      root = x;
-    } else {
-      propagate_left_size(y, -y->size);  // CHECKME
-      propagate_left_one(y, -popcount(y->value));  // CHECKME
-      size_t ydir = (y == y->parent->children[1]);
-      y->parent->children[ydir] = x;
-    }
-    node* xparent = y->parent;  // x may be nil
-    bool fix_needed = (y->color == node::BLACK);
-    if (y != nd) {
-      y->parent = nd->parent;
-      y->children[0] = nd->children[0];
-      y->children[1] = nd->children[1];
-      y->color = nd->color;
-
-      if (y->children[0]) y->children[0]->parent = y;
-      if (y->children[1]) y->children[1]->parent = y;
-      if (y->parent) {
-        y->parent->children[nd == nd->parent->children[1]] = y;
-      } else {
-        root = y;
-      }
-      if (xparent == nd) {
-        xparent = y;
-        if (x) x->parent = y;
-      }
-
-      propagate_left_size(y, y->size-nd->size);
-      y->left_size = left_size;
-      propagate_left_one(y, popcount(y->value)-popcount(nd->value));
-      y->left_one = left_one;
-    }
-    inspect();
-    if (fix_needed) erase_fixup(x, xparent);
-
-    nd->color = node::RED;
-    nd->children[0] = nd->children[1] = nd->parent = nullptr;
-    nd->left_size = 0;
-    nd->left_one = 0;
-
-    if (nd == first) first = after;
-    delete nd;
-    return after;
-  }
-
-  std::pair<iterator, size_t> nth(size_t pos) const {
-    if (pos == 0) return {begin(), 0};
-    node* res = root;
-    if (pos == size_) {
-      while (res->children[1]) res = res->children[1];
-      return {iterator(res, root), res->size-1};
-    }
-    while (!(res->left_size <= pos && pos < res->left_size + res->size)) {
-      if (res->left_size + res->size <= pos) {
-        pos -= res->left_size + res->size;
-        res = res->children[1];
-      } else {
-        res = res->children[0];
-      }
-    }
-    pos -= res->left_size;
-    return {iterator(res, root), pos};
-  }
-
-public:
-  bit_vector() = default;
-
-  bit_vector(const std::vector<bool>& bv) {
-    for (size_t i = 0; i+63 < bv.size(); i += 64) {
-      value_type cur = 0;
-      for (size_t j = 0; j < 64; ++j)
-        if (bv[i+j]) cur |= static_cast<value_type>(1) << j;
-
-      node* newnode = new node(cur, 64);
-      insert(nullptr, newnode);
-    }
-
-    size_t rem = bv.size() % 64;
-    if (rem > 0) {
-      size_t i = bv.size() / 64 * 64;
-      value_type cur = 0;
-      for (size_t j = 0; j < rem; ++j)
-        if (bv[i+j]) cur |= static_cast<value_type>(1) << j;
-
-      node* newnode = new node(cur, rem);
-      insert(nullptr, newnode);
-    }
-  }
-
-  size_t size() const { return size_; }
-  bool empty() const { return size_ == 0; }
-  size_t rank(int x, size_t t) const { return x? rank1(t) : rank0(t); }
-  size_t select(int x, size_t t) const { return x? select1(t) : select0(t); }
-
-  size_t rank0(size_t t) const { return t - rank1(t); }
-  size_t rank1(size_t t) const {
-    if (t == 0) return 0;
-
-    node* cur = root;
-    size_t res = 0;
-    if (t == size_) {
-      while (cur) {
-        res += cur->left_one + popcount(cur->value);
-        cur = cur->children[1];
-      }
-      return res;
-    }
-
-    while (!(cur->left_size <= t && t < cur->left_size + cur->size)) {
-      if (cur->left_size + cur->size <= t) {
-        t -= cur->left_size + cur->size;
-        res += cur->left_one + popcount(cur->value);
-        cur = cur->children[1];
-      } else {
-        cur = cur->children[0];
-      }
-    }
-    t -= cur->left_size;
-    res += cur->left_one;
-    res += popcount(cur->value & ((static_cast<value_type>(1) << t) - 1));
-    return res;
-  }
-
-  size_t select0(size_t t) const {
-    if (t == 0) return 0;
-    if (t > rank0(size_)) return -1;
-
-    node* cur = root;
-    size_t res = 0;
-    while (!((cur->left_size - cur->left_one) < t
-             && t <= (cur->left_size - cur->left_one) + (cur->size - popcount(cur->value)))) {
+#include "../../DataStructure/dynamic_bit_vector.cpp"
 
-      if ((cur->left_size - cur->left_one) + (cur->size - popcount(cur->value)) < t) {
-        t -= (cur->left_size - cur->left_one) + (cur->size - popcount(cur->value));
-        res += cur->left_size + cur->size;
-        cur = cur->children[1];
-      } else {
-        cur = cur->children[0];
-      }
-    }
-    t -= cur->left_size - cur->left_one;
-    res += cur->left_size;
-    for (size_t i = 0; t; ++i) {
-      if (!(cur->value >> i & 1)) --t;
-      ++res;
-    }
-    return res;
-  }
-  size_t select1(size_t t) const {
-    if (t == 0) return 0;
-    if (t > rank1(size_)) return -1;
-
-    node* cur = root;
-    size_t res = 0;
-    while (!(cur->left_one < t && t <= cur->left_one + popcount(cur->value))) {
-      if (cur->left_one + popcount(cur->value) < t) {
-        t -= cur->left_one + popcount(cur->value);
-        res += cur->left_size + cur->size;
-        cur = cur->children[1];
-      } else {
-        cur = cur->children[0];
-      }
-    }
-    t -= cur->left_one;
-    res += cur->left_size;
-    for (size_t i = 0; t; ++i) {
-      if (cur->value >> i & 1) --t;
-      ++res;
-    }
-    return res;
-  }
-
-  void insert(size_t t, int x) {
-    if (!root) {
-      assert(t == 0);
-      insert(nullptr, new node((x == 1), 1));
-      return;
-    }
-
-    iterator it;
-    size_t ind;
-    if (t == size_) {
-      node* cur = root;
-      while (cur->children[1]) cur = cur->children[1];
-      it = iterator(cur, root);
-      ind = cur->size;
-    } else {
-      std::tie(it, ind) = nth(t);
-    }
-    bool appended = false;
-    if (it->size == 64) {
-      value_type tmp = *it;
-      value_type hi = tmp >> 32;
-      value_type lo = tmp & ((static_cast<value_type>(1) << 32) - 1);
-      it->size = 32;
-      size_ -= 32;
-      *it = hi;
-      propagate_left_size(it.nd, -32);
-      propagate_left_one(it.nd, -popcount(lo));
-      node* newnode = new node(lo, 32);
-      insert(it.nd, newnode);
-      appended = true;
-
-      if (ind < 32) {
-        --it;
-      } else {
-        ind -= 32;
-      }
-    }
-
-    value_type tmp = *it;
-    value_type hi = tmp >> ind << (ind+1);
-    value_type lo = tmp & ((static_cast<value_type>(1) << ind) - 1);
-    value_type cur = (hi | lo);
-    if (x) {
-      cur |= static_cast<value_type>(1) << ind;
-      propagate_left_one(it.nd, 1);
-    }
-    *it = cur;
-    ++it->size;
-    ++size_;
-    propagate_left_size(it.nd, 1);
-    if (appended) {
-      inspect();
-    }
-  }
-
-  void erase(size_t t) {
-    iterator it;
-    size_t ind;
-    std::tie(it, ind) = nth(t);
-    if (it->size == 1) {
-      erase(it);
-      return;
-    }
-
-    value_type tmp = *it;
-    value_type hi = (ind < 63)? (tmp >> (ind+1) << ind) : 0;
-    value_type lo = tmp & ((static_cast<value_type>(1) << ind) - 1);
-
-    value_type cur = (hi | lo);
-    if (*it >> ind & 1) {
-      propagate_left_one(it.nd, -1);
-    }
-    *it = cur;
-    --it->size;
-    --size_;
-    propagate_left_size(it.nd, -1);
-
-    if (it->successor() && it->size + it->successor()->size <= 64) {
-      iterator succ(it->successor(), root);
-      *it |= (*succ << (it->size));
-      it->size += succ->size;
-      size_ += succ->size;
-      propagate_left_size(it.nd, succ->size);
-      propagate_left_one(it.nd, popcount(*succ));
-      erase(succ);
-    } else if (it->predecessor() && it->size + it->predecessor()->size <= 64) {
-      iterator pred(it->predecessor(), root);
-      *pred |= (*it << (pred->size));
-      pred->size += it->size;
-      size_ += it->size;
-      propagate_left_size(pred.nd, it->size);
-      propagate_left_one(pred.nd, popcount(*it));
-      erase(it);
-    }
-  }
-
-  bool operator [](size_t t) const {
-    iterator it;
-    size_t ind;
-    std::tie(it, ind) = nth(t);
-    return it[ind];
-  }
-
-  void inspect() const {
-    for (iterator it(first, root); it.nd != nullptr; ++it) {
-      fprintf(stderr,
-              "%016jx (size: %zu, left size: %zu, left one: %zu)",
-              *it, it->size, it->left_size, it->left_one);
-
-      if (it->children[0])
-        fprintf(stderr, " L: %zu", it->children[0]->size);
-
-      if (it->children[1])
-        fprintf(stderr, " R: %zu", it->children[1]->size);
-
-      fprintf(stderr, "\n");
-    }
-  }
-};
+using bit_vector = dynamic_bit_vector;
 
 template <typename Tp, size_t bitlen = 8 * sizeof(Tp)>
 class wavelet_matrix {
@@ -597,27 +37,68 @@ private:
     return s;
   }
 
+  static constexpr size_t S_batch_ratio = 1024;
+
+  class level_stream {
+    // copies the bits of a level to new words, counting the ones
+    std::vector<uint64_t> M_old, M_new;
+    size_t M_read = 0, M_written = 0, M_ones = 0;
+
+  public:
+    level_stream(bit_vector const& b, size_t n): M_old(b.words()), M_new(n / 64 + 2) {}
+
+    void put(uint64_t x, size_t len) {
+      // len (<= 64) bits
+      if (len == 0) return;
+      size_t sh = M_written % 64;
+      M_new[M_written / 64] |= x << sh;
+      if (sh + len > 64) M_new[M_written / 64 + 1] |= x >> (64 - sh);
+      M_written += len;
+    }
+
+    void copy_until(size_t pos) {
+      while (M_read < pos) {
+        size_t len = std::min<size_t>(64, pos - M_read);
+        size_t sh = M_read % 64;
+        uint64_t x = M_old[M_read / 64] >> sh;
+        if (sh) x |= M_old[M_read / 64 + 1] << (64 - sh);
+        if (len < 64) x &= (static_cast<uint64_t>(1) << len) - 1;
+        put(x, len);
+        M_ones += __builtin_popcountll(x);
+        M_read += len;
+      }
+    }
+
+    int skip() {
+      int x = M_old[M_read / 64] >> (M_read % 64) & 1;
+      ++M_read;
+      M_ones += x;
+      return x;
+    }
+
+    size_t ones() const { return M_ones; }
+    std::vector<uint64_t> const& words() const { return M_new; }
+  };
+
 public:
   wavelet_matrix(): zeros(bitlen), n(0) {}
 
   template <class ForwardIt>
   wavelet_matrix(ForwardIt first, ForwardIt last): zeros(bitlen) {
-    std::vector<value_type> c(first, last);
-    n = c.size();
-    std::vector<value_type> whole = c;
+    // each level built bottom-up from its words; the bits are set one at a
+    // time and every level is stable_partition()ed, in O(n bitlen)
+    std::vector<value_type> whole(first, last);
+    n = whole.size();
     for (size_t i = bitlen; i--;) {
-      std::vector<value_type> zero, one;
-      std::vector<bool> vb(n);
-      for (size_t j = 0; j < n; ++j) {
-        ((whole[j] >> i & 1)? one:zero).push_back(whole[j]);
-        vb[j] = (whole[j] >> i & 1);
-      }
-
-      zeros[bitlen-i-1] = zero.size();
-      a[bitlen-i-1] = bit_vector(vb);
-      if (i == 0) break;
-      whole = std::move(zero);
-      whole.insert(whole.end(), one.begin(), one.end());
+      size_t j = bitlen-i-1;
+      std::vector<uint64_t> words(n / 64 + 1);
+      for (size_t k = 0; k < n; ++k)
+        words[k / 64] |= static_cast<uint64_t>(whole[k] >> i & 1) << (k % 64);
+      a[j] = bit_vector(words, n);
+      auto mid = std::stable_partition(whole.begin(), whole.end(), [i](value_type x) {
+        return !(x >> i & 1);
+      });
+      zeros[j] = mid - whole.begin();
     }
   }
 
@@ -904,6 +385,78 @@ public:
     insert(t, x);
   }
 
+  void insert_batch(std::vector<std::pair<size_t, value_type>> xs) {
+    // inserts each x before the t-th of the elements before the batch,
+    // those for the same t in the given order.  Small batches are
+    // inserted one by one, and larger ones merged into each level in
+    // one pass, with the new elements kept in their order there along
+    // with the numbers of old elements before them.
+    std::stable_sort(xs.begin(), xs.end(), [](auto const& x, auto const& y) {
+      return x.first < y.first;
+    });
+    if (xs.size() * S_batch_ratio < n) {
+      for (size_t k = 0; k < xs.size(); ++k) insert(xs[k].first + k, xs[k].second);
+      return;
+    }
+
+    size_t m = n + xs.size();
+    std::vector<std::pair<size_t, value_type>> zero, one;
+    for (size_t i = bitlen; i--;) {
+      size_t j = bitlen-i-1;
+      level_stream ls(a[j], m);
+      zero.clear();
+      one.clear();
+      for (auto const& [t, x]: xs) {
+        ls.copy_until(t);
+        ls.put(x >> i & 1, 1);
+        if (x >> i & 1) {
+          one.emplace_back(zeros[j] + ls.ones(), x);
+        } else {
+          zero.emplace_back(t - ls.ones(), x);
+        }
+      }
+      ls.copy_until(n);
+      a[j] = bit_vector(ls.words(), m);
+      zeros[j] += zero.size();
+      xs = zero;
+      xs.insert(xs.end(), one.begin(), one.end());
+    }
+    n = m;
+  }
+
+  void erase_batch(std::vector<size_t> ts) {
+    // erases the elements at distinct positions ts, in the same way
+    std::sort(ts.begin(), ts.end());
+    if (ts.size() * S_batch_ratio < n) {
+      for (size_t k = ts.size(); k--;) erase(ts[k]);
+      return;
+    }
+
+    size_t m = n - ts.size();
+    std::vector<size_t> zero, one;
+    for (size_t i = bitlen; i--;) {
+      size_t j = bitlen-i-1;
+      level_stream ls(a[j], m);
+      zero.clear();
+      one.clear();
+      for (auto t: ts) {
+        ls.copy_until(t);
+        size_t ones = ls.ones();
+        if (ls.skip()) {
+          one.push_back(zeros[j] + ones);
+        } else {
+          zero.push_back(t - ones);
+        }
+      }
+      ls.copy_until(n);
+      a[j] = bit_vector(ls.words(), m);
+      zeros[j] -= zero.size();
+      ts = zero;
+      ts.insert(ts.end(), one.begin(), one.end());
+    }
+    n = m;
+  }
+
   void inspect() const {
     for (size_t i = 0; i < bitlen; ++i) {
       fprintf(stderr, "%zu (%zu): ", i, zeros[i]);
@@ -1091,4 +644,5 @@ int main() {
   wavelet_matrix<int, 4> wm;
   wm.insert(0, 3);
   wm.inspect();
+  return 0;
 }
@@ -249,7 +249,7 @@ class bit_vector {
     res += S_select(M_c[j0], j1);
     return res;
   }
-  size_t M_select0(size_t i) const {
+  size_t M_select0(size_t) const {
     // ???
     return -1;
   }
@@ -703,4 +703,5 @@ int dp_q() {
 int main() {
   // hack();
   dp_q();
+  return 0;
 }
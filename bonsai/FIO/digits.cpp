@@ -0,0 +1,81 @@
+#include <cstdio>
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+#include <cstring>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../../FastIO/fastio.cpp"
+
+// usage: ./digits [tokens] < /dev/null
+// Prints ns/token for each (type width, digit length, parser); the
+// choice in fast::auto_digits is made from this table.
+
+double now() {
+  using namespace std::chrono;
+  return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+std::mt19937_64 rsk(0315);
+
+template <typename Tp>
+std::vector<char> generate(size_t n, int len, int max_len) {
+  // n tokens of exactly len digits (with '-' for half of them if signed);
+  // of random lengths in [1, max_len] if len == 0.
+  std::vector<char> res;
+  for (size_t i = 0; i < n; ++i) {
+    if (std::is_signed<Tp>::value && rsk() % 2) res.push_back('-');
+    int k = (len > 0)? len: 1 + rsk() % max_len;
+    res.push_back('1' + rsk() % 9);
+    for (int j = 1; j < k; ++j) res.push_back('0' + rsk() % 10);
+    res.push_back(' ');
+  }
+  res.resize(res.size() + fast::margin, 0);
+  return res;
+}
+
+template <typename Policy, typename Tp>
+double measure(std::vector<char>& s, size_t n, Tp& sum) {
+  double start = now();
+  char* p = s.data();
+  for (size_t i = 0; i < n; ++i) {
+    Tp x;
+    p = Policy::parse(p, x) + 1;
+    sum += x;
+  }
+  return (now() - start) / n * 1e9;
+}
+
+template <typename Tp>
+void bench(char const* name, int max_len, size_t n) {
+  std::vector<int> lens{0};
+  for (int len = 1; len < max_len; len += (len < 4? 1: 3)) lens.push_back(len);
+  lens.push_back(max_len);
+  for (int len: lens) {
+    auto s = generate<Tp>(n, len, max_len);
+    Tp sum[4] = {};
+    double t[4] = {
+      measure<fast::serial_digits>(s, n, sum[0]),
+      measure<fast::swar_digits>(s, n, sum[1]),
+      measure<fast::simd_digits>(s, n, sum[2]),
+      measure<fast::auto_digits>(s, n, sum[3]),
+    };
+    for (int i = 1; i < 4; ++i) assert(sum[i] == sum[0]);
+    fprintf(stderr, "%-9s %5s  %7.2f %7.2f %7.2f %7.2f\n",
+            name, len? std::to_string(len).c_str(): "mixed", t[0], t[1], t[2], t[3]);
+  }
+}
+
+int main(int argc, char* argv[]) {
+  size_t n = (argc > 1)? strtoull(argv[1], nullptr, 10): 4000000;
+  fprintf(stderr, "type        len   serial    swar    simd    auto\n");
+  bench<int16_t>("int16", 4, n);
+  bench<uint16_t>("uint16", 4, n);
+  bench<int32_t>("int32", 9, n);
+  bench<uint32_t>("uint32", 9, n);
+  bench<int64_t>("int64", 18, n);
+  bench<uint64_t>("uint64", 19, n);
+}
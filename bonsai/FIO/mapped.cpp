@@ -0,0 +1,72 @@
+#include <cstdio>
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+#include <cstring>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "../../FastIO/fastio.cpp"
+
+// usage:
+//   ./scan_n gen 10000000 < /dev/null > in.txt
+//   ./mapped < in.txt
+// The input must be a regular file, since each method reads it from
+// the beginning.
+
+using intype = long long;
+
+double now() {
+  using namespace std::chrono;
+  return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+int main() {
+  rewind(stdin);
+  std::vector<intype> a, b;
+  {
+    double start = now();
+    fast::scanner sc;
+    size_t n;
+    sc.scan(n);
+    a.resize(n);
+    for (auto& ai: a) sc.scan(ai);
+    fprintf(stderr, "scanner::scan          %8.3f s\n", now() - start);
+  }
+
+  {
+    double start = now();
+    fast::mapped_scanner sc;
+    double mapped = now();
+    size_t n;
+    sc.scan(n);
+    b.resize(n);
+    for (auto& bi: b) sc.scan(bi);
+    fprintf(stderr, "mapped_scanner::scan   %8.3f s (%s: %.3f s)\n", now() - start,
+            sc.source().is_mapped()? "mmap": "read", mapped - start);
+    assert(a == b);
+  }
+
+  {
+    double start = now();
+    fast::mapped_scanner sc;
+    size_t n;
+    sc.scan(n);
+    b.assign(n, 0);
+    size_t m = sc.scan_n(b.data(), n);
+    fprintf(stderr, "mapped_scanner::scan_n %8.3f s\n", now() - start);
+    assert(m == n);
+    assert(a == b);
+  }
+
+  {
+    double start = now();
+    fast::mapped_scanner sc;
+    size_t bytes = 0, count = 0;
+    for (std::string_view s; !(s = sc.token()).empty(); ++count)
+      bytes += s.size();
+    fprintf(stderr, "mapped_scanner::token  %8.3f s (%zu tokens, %zu bytes)\n",
+            now() - start, count, bytes);
+  }
+}
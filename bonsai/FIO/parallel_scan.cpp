@@ -0,0 +1,48 @@
+#include <cstdio>
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+#include <cstring>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../../FastIO/fastio.cpp"
+
+// usage:
+//   ./scan_n gen 100000000 < /dev/null > in.txt
+//   ./parallel_scan < in.txt
+// Reports scan_vector(n, k) for k = 1, 2, 4, ... up to the number of
+// cores, against scan_n(n) of the same mapped_scanner.
+
+using intype = long long;
+
+double now() {
+  using namespace std::chrono;
+  return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+int main() {
+  std::vector<intype> expected;
+  {
+    fast::mapped_scanner sc;
+    size_t n;
+    sc.scan(n);
+    expected.resize(n);
+    double start = now();
+    assert(sc.scan_n(expected.data(), n) == n);
+    fprintf(stderr, "scan_n             %8.3f s\n", now() - start);
+  }
+
+  size_t cores = std::max(1u, std::thread::hardware_concurrency());
+  for (size_t k = 1; k <= 2*cores; k *= 2) {
+    fast::mapped_scanner sc;
+    size_t n;
+    sc.scan(n);
+    double start = now();
+    std::vector<intype> a = sc.scan_vector<intype>(n, k);
+    fprintf(stderr, "scan_vector (%3zu)  %8.3f s\n", k, now() - start);
+    assert(a == expected);
+  }
+}
@@ -0,0 +1,46 @@
+#include <cstdio>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "../../FastIO/fastio.cpp"
+
+// usage:
+//   ./scan_n gen 100000000 < /dev/null > in.txt
+//   cat in.txt | ./prefetch sync
+//   cat in.txt | ./prefetch async
+// The async mode should take about max(read, parse) rather than
+// read + parse when another core is free.
+
+using intype = long long;
+
+double now() {
+  using namespace std::chrono;
+  return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+template <typename Scanner>
+void run(char const* name) {
+  double start = now();
+  Scanner sc;
+  std::vector<intype> a(1 << 16);
+  intype sum = 0;
+  size_t count = 0;
+  while (size_t m = sc.scan_n(a.data(), a.size())) {
+    for (size_t i = 0; i < m; ++i) sum += a[i];
+    count += m;
+  }
+  fprintf(stderr, "%-6s %8.3f s (%zu integers, sum: %lld)\n",
+          name, now() - start, count, sum);
+}
+
+int main(int argc, char* argv[]) {
+  if (argc > 1 && strcmp(argv[1], "async") == 0) {
+    run<fast::prefetching_scanner>("async");
+  } else {
+    run<fast::scanner>("sync");
+  }
+}
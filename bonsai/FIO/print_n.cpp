@@ -0,0 +1,60 @@
+#include <cstdio>
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+#include <cstring>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../../FastIO/fastio.cpp"
+
+// usage: ./print_n [n [method]] < /dev/null > /dev/null
+// With method given, only that one runs, so that the outputs can be
+// compared with each other.
+
+using outtype = long long;
+
+double now() {
+  using namespace std::chrono;
+  return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+char const* only = nullptr;
+
+template <typename Fn>
+void bench(char const* name, std::vector<outtype> const& a, Fn fn) {
+  if (only && strcmp(only, name) != 0) return;
+  double start = now();
+  fn(a);
+  fflush(stdout);
+  fprintf(stderr, "%-14s %8.3f s\n", name, now() - start);
+}
+
+int main(int argc, char* argv[]) {
+  size_t n = (argc > 1)? strtoull(argv[1], nullptr, 10): 10000000;
+  if (argc > 2) only = argv[2];
+  std::mt19937_64 rng(0315);
+  std::vector<outtype> a(n);
+  for (auto& ai: a) ai = static_cast<outtype>(rng()) >> (rng() % 64);
+  a[0] = std::numeric_limits<outtype>::min();
+  a[1] = 0;
+
+  bench("printf", a, [](auto const& a) {
+    for (auto ai: a) printf("%lld\n", ai);
+  });
+  bench("print_serial", a, [](auto const& a) {
+    fast::printer pr;
+    for (auto ai: a) pr.print_serial(ai), pr.print('\n');
+  });
+  bench("print_table", a, [](auto const& a) {
+    fast::printer pr;
+    for (auto ai: a) pr.print_table(ai), pr.print('\n');
+  });
+  bench("print_n", a, [](auto const& a) {
+    fast::printer pr;
+    pr.print_n(a.data(), a.size(), '\n');
+    pr.print('\n');
+  });
+}
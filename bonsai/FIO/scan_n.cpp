@@ -0,0 +1,73 @@
+#include <cstdio>
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+#include <cstring>
+#include <cstdlib>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../../FastIO/fastio.cpp"
+
+// usage:
+//   ./scan_n gen 10000000 < /dev/null > in.txt
+//   ./scan_n < in.txt
+// The input must be a regular file, since it is rewound for each method.
+
+using intype = long long;
+
+double now() {
+  using namespace std::chrono;
+  return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+template <typename Fn>
+void bench(char const* name, size_t n, std::vector<intype> const& expected, Fn fn) {
+  rewind(stdin);
+  fseek(stdin, 0, SEEK_END);
+  double bytes = ftell(stdin);
+  rewind(stdin);
+
+  std::vector<intype> a(n);
+  double start = now();
+  fast::scanner sc;
+  size_t m;
+  sc.scan(m);
+  assert(m == n);
+  fn(sc, a);
+  double elapsed = now() - start;
+  if (!expected.empty()) assert(a == expected);
+  fprintf(stderr, "%-14s %8.3f s  %6.3f GB/s\n", name, elapsed, bytes / elapsed * 1e-9);
+}
+
+int main(int argc, char* argv[]) {
+  if (argc > 2 && std::string(argv[1]) == "gen") {
+    size_t n = strtoull(argv[2], nullptr, 10);
+    std::mt19937_64 rng(0315);
+    std::uniform_int_distribution<intype> dist(-1000000000000, 1000000000000);
+    printf("%zu\n", n);
+    for (size_t i = 0; i < n; ++i)
+      printf("%lld%c", dist(rng) >> (rng() % 40), i+1<n? ' ': '\n');
+    return 0;
+  }
+
+  size_t n;
+  cin.scan(n);
+  std::vector<intype> expected;
+  bench("scan_serial", n, expected, [&](auto& sc, auto& a) {
+    for (auto& ai: a) sc.scan_serial(ai);
+    expected = a;
+  });
+  bench("scan_parallel", n, expected, [](auto& sc, auto& a) {
+    for (auto& ai: a) sc.scan_parallel(ai);
+  });
+  bench("scan_simd", n, expected, [](auto& sc, auto& a) {
+    for (auto& ai: a) sc.scan_simd(ai);
+  });
+  bench("scan_n", n, expected, [](auto& sc, auto& a) {
+    size_t m = sc.scan_n(a.data(), a.size());
+    assert(m == a.size());
+  });
+}
@@ -0,0 +1,53 @@
+#include <cstdio>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../../FastIO/fastio.cpp"
+
+// usage: ./writer [n [method]] < /dev/null > out.txt
+// With method given, only that one runs, so that the outputs can be
+// compared with each other.  Writing into a file (or a pipe) rather than
+// /dev/null shows the cost of the syscalls and the extra stdio copy.
+
+using outtype = long long;
+
+char const* only = nullptr;
+
+double now() {
+  using namespace std::chrono;
+  return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+template <typename Printer, typename... Args>
+void bench(char const* name, std::vector<outtype> const& a, Args... args) {
+  if (only && strcmp(only, name) != 0) return;
+  double start = now();
+  {
+    Printer pr(args...);
+    for (auto ai: a) pr.print(ai), pr.print('\n');
+  }
+  fflush(stdout);
+  fprintf(stderr, "%-16s %8.3f s\n", name, now() - start);
+}
+
+int main(int argc, char* argv[]) {
+  size_t n = (argc > 1)? strtoull(argv[1], nullptr, 10): 10000000;
+  if (argc > 2) only = argv[2];
+  std::mt19937_64 rng(0315);
+  std::vector<outtype> a(n);
+  for (auto& ai: a) ai = static_cast<outtype>(rng()) >> (rng() % 64);
+
+  size_t size = size_t(1) << 20;
+  bench<fast::printer>("stdio", a);
+  bench<fast::fd_printer>("fd", a);
+  bench<fast::fd_printer>("fd-1MiB", a, size);
+  bench<fast::fd_printer>("fd-1MiB-huge", a, size, true);
+  bench<fast::async_printer>("async", a);
+  bench<fast::async_printer>("async-1MiB", a, size);
+  bench<fast::async_printer>("async-1MiB-huge", a, size, true);
+}
@@ -0,0 +1,215 @@
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <climits>
+#include <cassert>
+#include <chrono>
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "../../DataStructure/segment_tree.cpp"
+
+// usage: ./lazy [n [method]]
+// Runs n (default: 10^6) random range additions and range sums, mixed
+// half and half, and n prefix searches for a bound on the sum, on
+// segment_tree and on the previous version ("old"), which searches by
+// bisection on accumulate().  Prints ns/operation and checks the
+// answers against each other.
+
+template <
+  typename Monoid,
+  typename Container = std::vector<typename Monoid::first_type>,
+  typename SubContainer = std::vector<typename Monoid::second_type>
+>
+class old_segment_tree {
+  // the previous version, kept for comparison
+public:
+  using first_type = typename Monoid::first_type;
+  using second_type = typename Monoid::second_type;
+  using value_type = first_type;
+  using binary_operation = typename Monoid::binary_operation;
+  using external_binary_operation = typename Monoid::external_binary_operation;
+  using merge_operation = typename Monoid::merge_operation;
+  using container = Container;
+  using sub_container = SubContainer;
+
+private:
+  size_t M_base_size;
+  binary_operation M_op1;
+  external_binary_operation M_op2;
+  merge_operation M_op3;
+  container M_c;
+  sub_container M_d;  // deferred
+
+  void M_build(size_t i) {
+    while (i > 1) {
+      i >>= 1;
+      M_c[i] = M_op2(M_op1(M_c[i<<1|0], M_c[i<<1|1]), M_d[i]);
+    }
+  }
+
+  void M_resolve(size_t i) {
+    size_t h = (sizeof(long long) * CHAR_BIT) - __builtin_clzll(M_base_size*2);
+    for (size_t s = h; s > 0; --s) {
+      size_t p = i >> s;
+      if (M_d[p] != M_op3.identity) {
+        M_apply(p<<1|0, M_d[p]);
+        M_apply(p<<1|1, M_d[p]);
+        M_d[p] = M_op3.identity;
+      }
+    }
+  }
+
+  void M_apply(size_t i, second_type const& x) {
+    M_c[i] = M_op2(M_c[i], x);
+    if (i < M_base_size) M_d[i] = M_op3(M_d[i], x);
+  }
+
+public:
+  old_segment_tree() = default;
+  old_segment_tree(old_segment_tree const&) = default;
+  old_segment_tree(old_segment_tree&&) = default;
+
+  old_segment_tree(size_t n, first_type const& x = binary_operation().identity):
+    M_base_size(n),
+    M_op1(binary_operation()),
+    M_op2(external_binary_operation()),
+    M_op3(merge_operation()),
+    M_c(n+n, x), M_d(n, M_op3.identity)
+  {
+    for (size_t i = n; i--;)
+      M_c[i] = M_op1(M_c[i<<1|0], M_c[i<<1|1]);
+  }
+
+  template <typename InputIt>
+  old_segment_tree(InputIt first, InputIt last):
+    M_base_size(std::distance(first, last)),
+    M_op1(binary_operation()),
+    M_op2(external_binary_operation()),
+    M_op3(merge_operation()),
+    M_c(M_base_size*2), M_d(M_base_size, M_op3.identity)
+  {
+    for (size_t i = M_base_size; first != last; ++i)
+      M_c[i] = *first++;
+    for (size_t i = M_base_size; i--;)
+      M_c[i] = M_op1(M_c[i<<1|0], M_c[i<<1|1]);
+  }
+
+  old_segment_tree& operator =(old_segment_tree const&) = default;
+  old_segment_tree& operator =(old_segment_tree&&) = default;
+
+  void modify(size_t l, size_t r, second_type const& x) {
+    if (l == r) return;  // for [n, n)
+    l += M_base_size;
+    r += M_base_size;
+    size_t l0 = l;
+    size_t r0 = r;
+    while (l < r) {
+      if (l & 1) M_apply(l++, x);
+      if (r & 1) M_apply(--r, x);
+      l >>= 1;
+      r >>= 1;
+    }
+    M_build(l0);
+    M_build(r0-1);
+  }
+
+  first_type accumulate(size_t l, size_t r) {
+    first_type resl = M_op1.identity;
+    first_type resr = resl;
+    if (l == r) return resl;  // for [n, n)
+
+    l += M_base_size;
+    r += M_base_size;
+    M_resolve(l);
+    M_resolve(r-1);
+    while (l < r) {
+      if (l & 1) resl = M_op1(resl, M_c[l++]);
+      if (r & 1) resr = M_op1(M_c[--r], resr);
+      l >>= 1;
+      r >>= 1;
+    }
+    return M_op1(resl, resr);
+  }
+
+  first_type operator [](size_t i) {
+    i += M_base_size;
+    M_resolve(i);
+    return M_c[i];
+  }
+};
+
+std::mt19937_64 rsk(0315);
+char const* only = nullptr;
+
+double now() {
+  using namespace std::chrono;
+  return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+using monoid = range_sum_range_add<intmax_t>;
+
+struct query {
+  size_t l, r;
+  intmax_t x;  // 0 for a sum
+};
+
+template <typename Tree, typename Search>
+void bench(char const* name, size_t n, std::vector<query> const& qs,
+           std::vector<intmax_t>& expected, Search search) {
+  if (only && strcmp(name, only) != 0) return;
+  Tree st(n);
+  std::vector<intmax_t> res;
+
+  double start = now();
+  for (auto const& q: qs) {
+    if (q.x != 0) st.modify(q.l, q.r, q.x);
+    else res.push_back(st.accumulate(q.l, q.r).first);
+  }
+  double t_update = now() - start;
+
+  start = now();
+  for (auto const& q: qs) {
+    intmax_t bound = q.x * n / 4;
+    res.push_back(search(st, q.l, [bound](auto const& x) { return x.first <= bound; }));
+  }
+  double t_search = now() - start;
+
+  if (expected.empty()) expected = res;
+  assert(res == expected);
+  fprintf(stderr, "%-4s modify/accumulate %7.1f ns/op  max_right %7.1f ns/op\n",
+          name, t_update / qs.size() * 1e9, t_search / qs.size() * 1e9);
+}
+
+int main(int argc, char* argv[]) {
+  size_t n = (argc > 1)? strtoull(argv[1], nullptr, 10): 1000000;
+  if (argc > 2) only = argv[2];
+
+  std::vector<query> qs(n);
+  for (auto& q: qs) {
+    q.l = rsk() % (n+1);
+    q.r = rsk() % (n+1);
+    if (q.l > q.r) std::swap(q.l, q.r);
+    q.x = (rsk() % 2)? rsk() % 100 + 1: 0;
+  }
+  fprintf(stderr, "n = %zu\n", n);
+
+  std::vector<intmax_t> expected;
+  bench<segment_tree<monoid>>("new", n, qs, expected, [](auto& st, size_t l, auto pred) {
+    return st.max_right(l, pred);
+  });
+  bench<old_segment_tree<monoid>>("old", n, qs, expected, [n](auto& st, size_t l, auto pred) {
+    // the largest r with pred(accumulate(l, r)), by bisection
+    size_t lb = l;
+    size_t ub = n+1;
+    while (ub - lb > 1) {
+      size_t mid = (lb+ub) >> 1;
+      ((pred(st.accumulate(l, mid)))? lb: ub) = mid;
+    }
+    return lb;
+  });
+}
@@ -0,0 +1,112 @@
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <cassert>
+#include <chrono>
+#include <algorithm>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "../../DataStructure/basic_segment_tree.cpp"
+#include "../../utility/parallel_chunks.cpp"
+
+// usage: ./batch [n [k [threads]]]
+// On basic_segment_tree of n (default: 10^6) int64_t for sums, runs 10
+// rounds of k (default: 10^5) random point updates followed by k random
+// folds, one by one with modify() and accumulate(), and by modify_batch()
+// and accumulate_batch() on one thread and, with parallel_chunks, on the
+// given number (default: the hardware's) of threads.  Prints ns/operation with the speedup over
+// one by one, and checks the folds against each other.
+
+using monoid = range_sum_single_add<int64_t>;
+using tree = basic_segment_tree<monoid>;
+
+std::mt19937_64 rsk(0315);
+
+double now() {
+  using namespace std::chrono;
+  return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+struct phase {
+  std::vector<std::pair<size_t, int64_t>> updates;
+  std::vector<std::pair<size_t, size_t>> folds;
+};
+
+struct result {
+  double update = 0, fold = 0;
+  int64_t sum = 0;
+};
+
+template <typename Run>
+result bench(size_t n, std::vector<phase> const& rounds, Run run) {
+  std::vector<int64_t> a(n);
+  {
+    std::mt19937_64 gen(n);
+    for (auto& x: a) x = gen() % 1024;
+  }
+  tree st(a.begin(), a.end());
+  result res;
+  for (auto const& r: rounds) run(st, r, res);
+  return res;
+}
+
+void report(char const* name, result const& res, result const& base, size_t ops) {
+  fprintf(stderr, "%-10s update %7.1f ns/op (%4.1fx)  fold %7.1f ns/op (%4.1fx)\n",
+          name, res.update / ops * 1e9, base.update / res.update,
+          res.fold / ops * 1e9, base.fold / res.fold);
+}
+
+int main(int argc, char* argv[]) {
+  size_t n = (argc > 1)? strtoull(argv[1], nullptr, 10): 1000000;
+  size_t k = (argc > 2)? strtoull(argv[2], nullptr, 10): 100000;
+  size_t threads = (argc > 3)? strtoull(argv[3], nullptr, 10): std::thread::hardware_concurrency();
+  threads = std::max<size_t>(threads, 1);
+  fprintf(stderr, "n = %zu, k = %zu, threads = %zu\n", n, k, threads);
+
+  std::vector<phase> rounds(10);
+  for (auto& r: rounds) {
+    r.updates.resize(k);
+    for (auto& [i, x]: r.updates) {
+      i = rsk() % n;
+      x = rsk() % 1024;
+    }
+    r.folds.resize(k);
+    for (auto& [l, r]: r.folds) {
+      l = rsk() % (n+1);
+      r = rsk() % (n+1);
+      if (l > r) std::swap(l, r);
+    }
+  }
+
+  result one = bench(n, rounds, [](tree& st, phase const& r, result& res) {
+    double start = now();
+    for (auto [i, x]: r.updates) st.modify(i, x);
+    res.update += now() - start;
+    start = now();
+    for (auto [l, r]: r.folds) res.sum += st.accumulate(l, r);
+    res.fold += now() - start;
+  });
+
+  auto batch = [](auto chunks) {
+    return [chunks](tree& st, phase const& r, result& res) {
+      double start = now();
+      st.modify_batch(r.updates, chunks);
+      res.update += now() - start;
+      start = now();
+      for (auto x: st.accumulate_batch(r.folds, chunks)) res.sum += x;
+      res.fold += now() - start;
+    };
+  };
+  result single = bench(n, rounds, batch(tree::whole_chunk()));
+  result multi = bench(n, rounds, batch(parallel_chunks(threads)));
+  assert(single.sum == one.sum);
+  assert(multi.sum == one.sum);
+
+  size_t ops = k * rounds.size();
+  report("one by one", one, one, ops);
+  report("batch", single, one, ops);
+  report("batch-mt", multi, one, ops);
+}
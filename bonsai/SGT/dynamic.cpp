@@ -0,0 +1,128 @@
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <cassert>
+#include <chrono>
+#include <algorithm>
+#include <memory>
+#include <new>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <malloc.h>
+
+#include "../../DataStructure/segment_tree.cpp"
+#include "../../DataStructure/node_arena.cpp"
+#include "../../DataStructure/dynamic_segment_tree.cpp"
+#include "../heap_usage.cpp"
+
+// usage: ./dynamic [q [method]]
+// Runs q (default: 2*10^5) operations on keys in [0, 2^62), alternately
+// adding to a range and summing a range, with point updates ("point")
+// and with range updates ("range").  Compares the dynamic segment tree
+// ("dynamic"), which takes the keys online, with segment_tree on the
+// keys compressed beforehand ("compressed"), whose leaves are weighted
+// with the lengths they stand for.  Prints ns/operation, and the heap
+// per update, i.e. per touched point with point updates, and checks the
+// sums against each other.
+
+using monoid = range_sum_range_add<uint64_t>;
+constexpr size_t universe = size_t(1) << 62;
+
+std::mt19937_64 rsk(0315);
+char const* only = nullptr;
+
+double now() {
+  using namespace std::chrono;
+  return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+struct operation {
+  size_t l, r;
+  uint64_t x;  // 0 for sums
+};
+
+uint64_t run_dynamic(std::vector<operation> const& ops, size_t updates) {
+  size_t base = heap_cur;
+  double start = now();
+  dynamic_segment_tree<monoid> st(universe, {0, 1});
+  uint64_t res = 0;
+  for (auto [l, r, x]: ops) {
+    if (x) {
+      st.modify(l, r, x);
+    } else {
+      res += st.accumulate(l, r).first;
+    }
+  }
+  double t = now() - start;
+  size_t heap = heap_cur - base;
+  fprintf(stderr, "  dynamic     %7.1f ns/op  %8.1f MB  %7.1f B/update  (%.1f nodes/update)\n",
+          t / ops.size() * 1e9, heap / 1e6, double(heap) / updates, double(st.nodes()) / updates);
+  return res;
+}
+
+uint64_t run_compressed(std::vector<operation> const& ops, size_t updates) {
+  size_t base = heap_cur;
+  double start = now();
+  std::vector<size_t> cs = {0, universe};
+  for (auto const& op: ops) {
+    cs.push_back(op.l);
+    cs.push_back(op.r);
+  }
+  std::sort(cs.begin(), cs.end());
+  cs.erase(std::unique(cs.begin(), cs.end()), cs.end());
+  auto index = [&](size_t x) { return std::lower_bound(cs.begin(), cs.end(), x) - cs.begin(); };
+  std::vector<std::pair<uint64_t, uint64_t>> init;
+  for (size_t i = 0; i+1 < cs.size(); ++i) init.emplace_back(0, cs[i+1] - cs[i]);
+  segment_tree<monoid> st(init.begin(), init.end());
+  std::vector<std::pair<uint64_t, uint64_t>>().swap(init);
+
+  uint64_t res = 0;
+  for (auto [l, r, x]: ops) {
+    if (x) {
+      st.modify(index(l), index(r), x);
+    } else {
+      res += st.accumulate(index(l), index(r)).first;
+    }
+  }
+  double t = now() - start;
+  size_t heap = heap_cur - base;
+  fprintf(stderr, "  compressed  %7.1f ns/op  %8.1f MB  %7.1f B/update\n",
+          t / ops.size() * 1e9, heap / 1e6, double(heap) / updates);
+  return res;
+}
+
+void bench(char const* name, std::vector<operation> const& ops) {
+  size_t updates = 0;
+  for (auto const& op: ops) updates += (op.x != 0);
+  fprintf(stderr, "%s: %zu operations, %zu updates\n", name, ops.size(), updates);
+  uint64_t expected = 0;
+  bool done = false;
+  if (!only || strcmp(only, "dynamic") == 0) {
+    expected = run_dynamic(ops, updates);
+    done = true;
+  }
+  if (!only || strcmp(only, "compressed") == 0) {
+    uint64_t res = run_compressed(ops, updates);
+    if (done) assert(res == expected);
+  }
+}
+
+int main(int argc, char* argv[]) {
+  size_t q = (argc > 1)? strtoull(argv[1], nullptr, 10): 200000;
+  if (argc > 2) only = argv[2];
+
+  for (bool point: {true, false}) {
+    std::vector<operation> ops(q);
+    for (size_t j = 0; j < q; ++j) {
+      size_t l = rsk() % universe;
+      size_t r = rsk() % (universe+1);
+      if (l > r) std::swap(l, r);
+      if (j % 2 == 0 && point) r = l+1;
+      ops[j] = {l, r, (j % 2 == 0)? rsk() | 1: 0};
+    }
+    bench(point? "point": "range", ops);
+  }
+}
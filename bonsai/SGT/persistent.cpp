@@ -0,0 +1,153 @@
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <cassert>
+#include <chrono>
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <memory>
+#include <new>
+#include <queue>
+#include <random>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <malloc.h>
+
+#include "../../DataStructure/basic_segment_tree.cpp"
+#include "../../DataStructure/node_arena.cpp"
+#include "../../DataStructure/persistent_segment_tree.cpp"
+#include "../../DataStructure/wavelet_matrix.cpp"
+#include "../heap_usage.cpp"
+
+// usage: ./persistent [n [q]]
+// On n (default: 10^6) elements, makes q (default: 10^6) versions, each
+// by a point update of a random earlier one, and sums random ranges of
+// random versions.  Prints ns/operation, and the heap and nodes per
+// version.  Then releases all but one version of every 16 and collects,
+// printing the time taken, the heap before and after, and ns/sum after.
+// Last, finds the k-th smallest of random ranges of n values in [0, 2^20),
+// by descending two of the versions counting the values one by one,
+// against wavelet_matrix::quantile, and checks them against each other.
+
+using monoid = range_sum_single_add<uint64_t>;
+
+std::mt19937_64 rsk(0315);
+
+double now() {
+  using namespace std::chrono;
+  return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+uint64_t sums(persistent_segment_tree<monoid> const& st, std::vector<size_t> const& ts, size_t q) {
+  size_t n = st.size();
+  std::mt19937_64 rng(q);
+  uint64_t res = 0;
+  double start = now();
+  for (size_t j = 0; j < q; ++j) {
+    size_t t = ts[rng() % ts.size()];
+    size_t l = rng() % (n+1);
+    size_t r = rng() % (n+1);
+    if (l > r) std::swap(l, r);
+    res += st.accumulate(t, l, r);
+  }
+  double t = now() - start;
+  fprintf(stderr, "  accumulate  %7.1f ns/op\n", t / q * 1e9);
+  return res;
+}
+
+void bench_history(size_t n, size_t q) {
+  fprintf(stderr, "history: %zu elements, %zu versions\n", n, q);
+  std::vector<uint64_t> a(n);
+  for (auto& x: a) x = rsk() % 1000;
+
+  size_t base = heap_cur;
+  double start = now();
+  persistent_segment_tree<monoid> st(a.begin(), a.end());
+  double t = now() - start;
+  size_t initial = heap_cur - base;
+  fprintf(stderr, "  build       %7.1f ns/element  %8.1f MB\n", t / n * 1e9, initial / 1e6);
+
+  size_t nodes = st.nodes();
+  start = now();
+  for (size_t j = 0; j < q; ++j) {
+    size_t t = rsk() % st.versions();
+    st.modify(t, rsk() % n, rsk() % 1000);
+  }
+  t = now() - start;
+  size_t heap = heap_cur - base - initial;
+  fprintf(stderr, "  modify      %7.1f ns/op  %8.1f MB  %7.1f B/version  (%.1f nodes/version)\n",
+          t / q * 1e9, heap / 1e6, double(heap) / q, double(st.nodes() - nodes) / q);
+  assert(st.memory() <= heap_cur - base);
+
+  std::vector<size_t> all(st.versions());
+  for (size_t t = 0; t < all.size(); ++t) all[t] = t;
+  std::vector<size_t> kept;
+  for (size_t t = 0; t < all.size(); t += 16) kept.push_back(t);
+  uint64_t expected = sums(st, kept, q);
+
+  size_t before = heap_cur - base;
+  start = now();
+  for (size_t t = 0; t < all.size(); ++t)
+    if (t % 16 != 0) st.release(t);
+  st.collect();
+  t = now() - start;
+  fprintf(stderr, "  collect     %7.1f ms  %8.1f MB -> %.1f MB  (%zu versions kept)\n",
+          t * 1e3, before / 1e6, (heap_cur - base) / 1e6, kept.size());
+  uint64_t res = sums(st, kept, q);
+  assert(res == expected);
+}
+
+constexpr size_t bitlen = 20;
+
+void bench_quantile(size_t n, size_t q) {
+  fprintf(stderr, "quantile: %zu values in [0, 2^%zu), %zu queries\n", n, bitlen, q);
+  std::vector<uint32_t> a(n);
+  for (auto& x: a) x = rsk() % (size_t(1) << bitlen);
+  std::vector<std::tuple<size_t, size_t, size_t>> qs(q);
+  for (auto& [l, r, k]: qs) {
+    l = rsk() % n;
+    r = rsk() % n;
+    if (l > r) std::swap(l, r);
+    ++r;
+    k = rsk() % (r-l);
+  }
+
+  size_t base = heap_cur;
+  double start = now();
+  persistent_segment_tree<range_sum_single_add<uint32_t>> st(size_t(1) << bitlen);
+  for (auto x: a) st.modify(st.versions()-1, x, 1);
+  double t = now() - start;
+  fprintf(stderr, "  persistent  build %7.1f ns/element  %8.1f MB\n", t / n * 1e9, (heap_cur - base) / 1e6);
+  std::vector<uint32_t> expected;
+  start = now();
+  for (auto [l, r, k]: qs) expected.push_back(st.quantile(k, l, r));
+  t = now() - start;
+  fprintf(stderr, "  persistent  %7.1f ns/op\n", t / q * 1e9);
+
+  base = heap_cur;
+  start = now();
+  wavelet_matrix<uint32_t, bitlen> wm(a.begin(), a.end(), false);
+  t = now() - start;
+  fprintf(stderr, "  wavelet     build %7.1f ns/element  %8.1f MB\n", t / n * 1e9, (heap_cur - base) / 1e6);
+  start = now();
+  for (size_t j = 0; j < q; ++j) {
+    auto [l, r, k] = qs[j];
+    uint32_t res = wm.quantile(k, l, r);
+    assert(res == expected[j]);
+  }
+  t = now() - start;
+  fprintf(stderr, "  wavelet     %7.1f ns/op\n", t / q * 1e9);
+}
+
+int main(int argc, char* argv[]) {
+  size_t n = (argc > 1)? strtoull(argv[1], nullptr, 10): 1000000;
+  size_t q = (argc > 2)? strtoull(argv[2], nullptr, 10): 1000000;
+
+  bench_history(n, q);
+  bench_quantile(n, q);
+}
@@ -0,0 +1,98 @@
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <cassert>
+#include <chrono>
+#include <algorithm>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "../../DataStructure/basic_segment_tree.cpp"
+#include "../../DataStructure/wide_segment_tree.cpp"
+
+// usage: ./wide [n [method]]
+// Builds basic_segment_tree ("basic") and wide_segment_tree ("wide") of
+// n (default: 10^6) random int64_t for sums, and prints ns/query of
+// 10^6 random folds, independent (throughput) and each depending on
+// the previous answer (latency), and of partition_point().  Checks the
+// answers against each other.
+
+using monoid = range_sum_single_add<int64_t>;
+
+std::mt19937_64 rsk(0315);
+char const* only = nullptr;
+
+double now() {
+  using namespace std::chrono;
+  return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+struct result {
+  int64_t fold = 0, chain = 0;
+  size_t bound = 0;
+  bool operator ==(result const& other) const {
+    return fold == other.fold && chain == other.chain && bound == other.bound;
+  }
+};
+
+template <typename Tree>
+void bench(char const* name, size_t n, std::vector<std::pair<size_t, size_t>> const& qs,
+           std::vector<int64_t> const& bounds, result& expected) {
+  if (only && strcmp(name, only) != 0) return;
+  std::vector<int64_t> a(n);
+  {
+    std::mt19937_64 gen(n);
+    for (auto& x: a) x = gen() % 1024;
+  }
+  double start = now();
+  Tree st(a.begin(), a.end());
+  double t_build = now() - start;
+  std::vector<int64_t>().swap(a);
+
+  result res;
+  start = now();
+  for (auto [l, r]: qs) res.fold += st.accumulate(l, r);
+  double t_fold = now() - start;
+
+  start = now();
+  for (auto [l, r]: qs) {
+    size_t d = res.chain & 1;
+    res.chain += st.accumulate(l - (l > 0? d: 0), r);
+  }
+  double t_chain = now() - start;
+
+  start = now();
+  for (auto b: bounds) {
+    b ^= res.bound & 1;
+    res.bound += st.partition_point([b](int64_t x) { return x <= b; }).first;
+  }
+  double t_bound = now() - start;
+
+  if (expected == result()) expected = res;
+  assert(res == expected);
+  fprintf(stderr, "%-6s build %6.2f s  fold %7.1f  latency %7.1f  partition_point %7.1f ns/query\n",
+          name, t_build, t_fold / qs.size() * 1e9, t_chain / qs.size() * 1e9,
+          t_bound / bounds.size() * 1e9);
+}
+
+int main(int argc, char* argv[]) {
+  size_t n = (argc > 1)? strtoull(argv[1], nullptr, 10): 1000000;
+  if (argc > 2) only = argv[2];
+
+  size_t q = 1000000;
+  std::vector<std::pair<size_t, size_t>> qs(q);
+  for (auto& [l, r]: qs) {
+    l = rsk() % (n+1);
+    r = rsk() % (n+1);
+    if (l > r) std::swap(l, r);
+  }
+  std::vector<int64_t> bounds(q);
+  for (auto& b: bounds) b = rsk() % (512 * n);
+  fprintf(stderr, "n = %zu\n", n);
+
+  result expected;
+  bench<basic_segment_tree<monoid>>("basic", n, qs, bounds, expected);
+  bench<wide_segment_tree<monoid>>("wide", n, qs, bounds, expected);
+}
@@ -0,0 +1,88 @@
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <cassert>
+#include <chrono>
+#include <algorithm>
+#include <array>
+#include <random>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../../DataStructure/wavelet_matrix.cpp"
+
+// usage: ./batch [n [q]]
+// Builds a wavelet matrix of n (default: 2^24) random 32-bit values, and
+// answers q (default: 10^6) random queries of each kind one by one and
+// by the batch versions, printing ns/query.
+
+double now() {
+  using namespace std::chrono;
+  return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+template <typename Single, typename Batch>
+void bench(char const* name, size_t q, Single single, Batch batch) {
+  double start = now();
+  auto expected = single();
+  double mid = now();
+  auto res = batch();
+  double end = now();
+  assert(res == expected);
+  fprintf(stderr, "  %-16s single %8.2f  batch %8.2f ns/query  x%.2f\n", name,
+          (mid - start) / q * 1e9, (end - mid) / q * 1e9, (mid - start) / (end - mid));
+}
+
+int main(int argc, char* argv[]) {
+  size_t n = (argc > 1)? strtoull(argv[1], nullptr, 10): size_t(1) << 24;
+  size_t q = (argc > 2)? strtoull(argv[2], nullptr, 10): 1000000;
+
+  std::mt19937 rsk(0315);
+  std::vector<uint32_t> a(n);
+  for (auto& x: a) x = rsk();
+  wavelet_matrix<uint32_t> wm(a.begin(), a.end(), false);
+  fprintf(stderr, "n = %zu, q = %zu\n", n, q);
+
+  // values that occur, half of the time
+  auto value = [&] { return (rsk() % 2)? a[rsk() % n]: rsk(); };
+  std::vector<std::pair<uint32_t, size_t>> xt(q);
+  std::vector<std::array<size_t, 3>> kst(q);
+  std::vector<std::tuple<uint32_t, size_t, size_t>> xst(q);
+  for (size_t i = 0; i < q; ++i) {
+    size_t s = rsk() % n, t = rsk() % n;
+    if (s > t) std::swap(s, t);
+    ++t;
+    xt[i] = {value(), t};
+    kst[i] = {rsk() % (t-s), s, t};
+    xst[i] = {value(), s, t};
+  }
+
+  bench("rank", q, [&] {
+    std::vector<size_t> res;
+    for (auto [x, t]: xt) res.push_back(wm.rank(x, t));
+    return res;
+  }, [&] { return wm.rank_batch(xt); });
+  bench("rank_three_way", q, [&] {
+    std::vector<std::array<size_t, 3>> res;
+    for (auto [x, t]: xt) res.push_back(wm.rank_three_way(x, t));
+    return res;
+  }, [&] { return wm.rank_three_way_batch(xt); });
+  bench("quantile", q, [&] {
+    std::vector<uint32_t> res;
+    for (auto [k, s, t]: kst) res.push_back(wm.quantile(k, s, t));
+    return res;
+  }, [&] { return wm.quantile_batch(kst); });
+  bench("min_ge", q, [&] {
+    std::vector<std::pair<bool, uint32_t>> res;
+    for (auto [x, s, t]: xst) res.push_back(wm.min_ge(x, s, t));
+    return res;
+  }, [&] { return wm.min_ge_batch(xst); });
+  bench("max_le", q, [&] {
+    std::vector<std::pair<bool, uint32_t>> res;
+    for (auto [x, s, t]: xst) res.push_back(wm.max_le(x, s, t));
+    return res;
+  }, [&] { return wm.max_le_batch(xst); });
+}
@@ -0,0 +1,126 @@
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <cassert>
+#include <cmath>
+#include <chrono>
+#include <algorithm>
+#include <array>
+#include <new>
+#include <random>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <malloc.h>
+
+#include "../../DataStructure/wavelet_matrix.cpp"
+#include "../../DataStructure/rrr_vector.cpp"
+#include "../heap_usage.cpp"
+
+// usage: ./compressed [n [sigma]]
+// Builds wavelet matrices over n (default: 10^7) values drawn from a
+// Zipf distribution over [0, sigma) (default: 2^20), with the frequent
+// values small or shuffled, on bit_vector and on rrr_vector, and prints
+// the space in bits per symbol against the zero-order entropy, and
+// ns/query of access, rank and quantile.
+
+std::mt19937 rsk(0315);
+size_t volatile sink;
+
+double now() {
+  using namespace std::chrono;
+  return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+void verify(size_t n) {
+  for (size_t per_mille: {0, 1, 100, 500, 999, 1000}) {
+    std::vector<bool> vb(n);
+    for (size_t i = 0; i < n; ++i) vb[i] = (rsk() % 1000 < per_mille);
+    bit_vector expected(vb);
+    rrr_vector b(vb);
+    for (size_t i = 0; i <= n; ++i) assert(b.rank1(i) == expected.rank1(i));
+    for (size_t i = 0; i < n; ++i) assert(b[i] == vb[i]);
+    for (size_t k = 0; k <= n+1; ++k) {
+      assert(b.select1(k) == expected.select1(k));
+      assert(b.select0(k) == expected.select0(k));
+    }
+  }
+}
+
+template <typename WaveletMatrix, typename Fn>
+double per_query(WaveletMatrix const& wm, std::vector<std::array<size_t, 3>> const& qs, Fn fn) {
+  size_t sum = 0;
+  double start = now();
+  for (auto const& q: qs) sum += fn(wm, q);
+  double elapsed = now() - start;
+  sink = sum;
+  return elapsed / qs.size() * 1e9;
+}
+
+template <typename BitVector>
+void bench(char const* name, std::vector<uint32_t> const& a, bool keep_values,
+           std::vector<std::array<size_t, 3>> const& qs, std::vector<uint32_t>& answers) {
+  size_t base = heap_cur;
+  wavelet_matrix<uint32_t, 20, BitVector> wm(a.begin(), a.end(), keep_values);
+  double bits = (heap_cur - base) * 8.0 / a.size();
+
+  std::vector<uint32_t> res;
+  for (auto const& q: qs) res.push_back(wm.quantile(q[0], q[1], q[2]));
+  if (answers.empty()) answers = res;
+  assert(res == answers);
+  for (auto const& q: qs) assert(wm[q[1]] == a[q[1]]);
+
+  double access = per_query(wm, qs, [](auto const& wm, auto const& q) { return wm[q[1]]; });
+  double rank = per_query(wm, qs, [&](auto const& wm, auto const& q) {
+    return wm.rank(a[q[1]], q[2]);
+  });
+  double quantile = per_query(wm, qs, [](auto const& wm, auto const& q) {
+    return wm.quantile(q[0], q[1], q[2]);
+  });
+  fprintf(stderr, "  %-22s %6.2f bits/symbol  access %8.2f  rank %8.2f  quantile %8.2f ns/query\n",
+          name, bits, access, rank, quantile);
+}
+
+void bench_all(char const* kind, std::vector<uint32_t> const& a) {
+  std::vector<size_t> freq(*std::max_element(a.begin(), a.end()) + 1);
+  for (auto x: a) ++freq[x];
+  double h0 = 0;
+  for (auto f: freq)
+    if (f > 0) h0 -= f * std::log2(double(f) / a.size());
+  fprintf(stderr, "%s, n = %zu, H0 = %.2f bits/symbol\n", kind, a.size(), h0 / a.size());
+
+  std::vector<std::array<size_t, 3>> qs(100000);
+  for (auto& q: qs) {
+    size_t s = rsk() % a.size(), t = rsk() % a.size();
+    if (s > t) std::swap(s, t);
+    q = {rsk() % (t-s+1), s, t+1};
+  }
+  std::vector<uint32_t> answers;
+  bench<bit_vector>("bit_vector, with values", a, true, qs, answers);
+  bench<bit_vector>("bit_vector", a, false, qs, answers);
+  bench<rrr_vector>("rrr_vector", a, false, qs, answers);
+}
+
+int main(int argc, char* argv[]) {
+  size_t n = (argc > 1)? strtoull(argv[1], nullptr, 10): 10000000;
+  size_t sigma = (argc > 2)? strtoull(argv[2], nullptr, 10): size_t(1) << 20;
+  assert(sigma <= (size_t(1) << 20));
+
+  for (size_t m: {0, 1, 62, 63, 64, 2016, 2017, 100000}) verify(m);
+
+  std::vector<double> cum(sigma);
+  for (size_t i = 0; i < sigma; ++i) cum[i] = (i? cum[i-1]: 0) + 1 / std::pow(i+1, 1.1);
+  std::uniform_real_distribution<double> unif(0, cum.back());
+  std::vector<uint32_t> a(n);
+  for (auto& x: a) x = std::lower_bound(cum.begin(), cum.end(), unif(rsk)) - cum.begin();
+  bench_all("zipf, frequent values small", a);
+
+  std::vector<uint32_t> perm(sigma);
+  for (size_t i = 0; i < sigma; ++i) perm[i] = i;
+  std::shuffle(perm.begin(), perm.end(), rsk);
+  for (auto& x: a) x = perm[x];
+  bench_all("zipf, values shuffled", a);
+}
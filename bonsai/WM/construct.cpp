@@ -0,0 +1,106 @@
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <cassert>
+#include <chrono>
+#include <algorithm>
+#include <array>
+#include <new>
+#include <random>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <malloc.h>
+
+#include "../../DataStructure/wavelet_matrix.cpp"
+#include "../heap_usage.cpp"
+
+// usage: ./construct [n [max_threads]]
+// Builds wavelet matrices of n (default: 10^8) random 32-bit values, as
+// the previous constructor did and with the current one (keeping the
+// values or not, with 1, 2, 4, ..., max_threads threads), and prints the
+// time and the peak heap usage besides the input itself.
+
+template <class Tp, size_t bitlen = 8 * sizeof(Tp)>
+struct old_wavelet_matrix {
+  // only the previous constructor, kept for comparison
+  using value_type = typename std::make_unsigned<Tp>::type;
+  std::vector<value_type> c;
+  std::vector<size_t> zeros;
+  size_t n;
+  std::array<bit_vector, bitlen> a;
+
+  template <class InputIt>
+  old_wavelet_matrix(InputIt first, InputIt last):
+    c(first, last), zeros(bitlen), n(c.size())
+  {
+    std::vector<value_type> whole = c;
+    for (size_t i = bitlen; i--;) {
+      std::vector<value_type> zero, one;
+      std::vector<bool> vb(n);
+      for (size_t j = 0; j < n; ++j) {
+        ((whole[j] >> i & 1)? one:zero).push_back(whole[j]);
+        vb[j] = (whole[j] >> i & 1);
+      }
+
+      zeros[bitlen-i-1] = zero.size();
+      a[bitlen-i-1] = bit_vector(vb);
+      if (i == 0) break;
+      whole = std::move(zero);
+      whole.insert(whole.end(), one.begin(), one.end());
+    }
+  }
+};
+
+double now() {
+  using namespace std::chrono;
+  return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+template <typename Fn>
+void bench(char const* name, Fn fn) {
+  size_t base = heap_cur;
+  heap_peak = heap_cur;
+  double start = now();
+  fn();
+  double elapsed = now() - start;
+  fprintf(stderr, "  %-24s %8.3f s  %10.2f MiB peak\n",
+          name, elapsed, (heap_peak - base) / 1048576.0);
+}
+
+int main(int argc, char* argv[]) {
+  size_t n = (argc > 1)? strtoull(argv[1], nullptr, 10): 100000000;
+  size_t max_threads = (argc > 2)? strtoull(argv[2], nullptr, 10): 0;
+  if (max_threads == 0) max_threads = std::max(1u, std::thread::hardware_concurrency());
+
+  std::mt19937 rsk(0315);
+  std::vector<uint32_t> a(n);
+  for (auto& x: a) x = rsk();
+  fprintf(stderr, "n = %zu, input %.2f MiB\n", n, n * sizeof(uint32_t) / 1048576.0);
+
+  // the results are compared at some points, by descent or lookup
+  std::vector<size_t> points(1000);
+  for (auto& p: points) p = rsk() % n;
+  auto check = [&](auto const& wm) {
+    for (auto p: points) assert(wm[p] == a[p]);
+    for (auto p: points) assert(wm.quantile(0, p, p+1) == a[p]);
+  };
+
+  bench("old", [&] { old_wavelet_matrix<uint32_t> wm(a.begin(), a.end()); });
+  bench("keep_values", [&] {
+    wavelet_matrix<uint32_t> wm(a.begin(), a.end());
+    check(wm);
+  });
+  for (size_t k = 1; k <= max_threads; k = (k < max_threads && 2*k > max_threads)? max_threads: 2*k) {
+    char name[32];
+    snprintf(name, sizeof name, "%zu thread(s)", k);
+    bench(name, [&] {
+      wavelet_matrix<uint32_t> wm(a.begin(), a.end(), false, k);
+      check(wm);
+    });
+    if (k == max_threads) break;
+  }
+}
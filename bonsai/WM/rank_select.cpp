@@ -0,0 +1,202 @@
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <cassert>
+#include <chrono>
+#include <algorithm>
+#include <array>
+#include <random>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../../DataStructure/wavelet_matrix.cpp"
+
+// usage: ./rank_select [n [method]]
+// Builds bit vectors of n (default: 2^28) bits with 50%, 10% and 0.1%
+// ones, and prints ns/query of rank1, select1 and select0 with random
+// arguments, and of quantile on a wavelet matrix over n/64 values using
+// each bit vector.  Each query depends on the result of the last one, so
+// that the latency, rather than the throughput, is measured.  method is
+// either old or new.
+
+class old_bit_vector {
+  // the previous version, with a rank table per word and a binary search
+  // for select, kept for comparison
+  size_t n;
+  static constexpr size_t nbit = 64;
+  std::vector<intmax_t> raw;
+  std::vector<int> acc;
+
+  int popcount(uintmax_t x) const {
+    return __builtin_popcountll(x);
+  }
+
+public:
+  old_bit_vector() {}
+
+  old_bit_vector(const std::vector<bool>& b): n(b.size()) {
+    raw.assign(n/nbit+1, 0);
+    for (size_t i = 0; i < n; ++i)
+      if (b[i]) raw[i/nbit] |= intmax_t(1) << (i % nbit);
+
+    acc.assign(n/nbit+1, 0);
+    for (size_t i = 1; i < acc.size(); ++i)
+      acc[i] = acc[i-1] + popcount(raw[i-1]);
+  }
+
+  // as wavelet_matrix builds it now
+  explicit old_bit_vector(size_t n): n(n), raw(n/nbit+1), acc(n/nbit+1) {}
+  void set_word(size_t i, uint64_t x) { raw[i] = x; }
+  void build() {
+    for (size_t i = 1; i < acc.size(); ++i)
+      acc[i] = acc[i-1] + popcount(raw[i-1]);
+  }
+
+  size_t rank1(size_t k) const {
+    size_t large = k / nbit;
+    size_t small = k % nbit;
+    size_t res = acc[large];
+    if (small > 0) res += popcount(raw[large] & ((uintmax_t(1) << small) - 1));
+    return res;
+  }
+
+  size_t rank0(size_t k) const {
+    return k - rank1(k);
+  }
+
+  size_t select1(size_t k) const {
+    if (k == 0) return 0;
+    size_t lb = 0;
+    size_t ub = n;
+    while (ub-lb > 1) {
+      size_t mid = (lb+ub) >> 1;
+      ((rank1(mid) < k)? lb:ub) = mid;
+    }
+    if (rank1(ub) < k) return -1;
+    return ub;
+  }
+
+  size_t select0(size_t k) const {
+    if (k == 0) return 0;
+    size_t lb = 0;
+    size_t ub = n;
+    while (ub-lb > 1) {
+      size_t mid = (lb+ub) >> 1;
+      ((rank0(mid) < k)? lb:ub) = mid;
+    }
+    if (rank0(ub) < k) return -1;
+    return ub;
+  }
+
+  size_t rank(int x, size_t k) const {
+    return x? rank1(k) : rank0(k);
+  }
+
+  size_t select(int x, size_t k) const {
+    return x? select1(k) : select0(k);
+  }
+
+  bool operator [](size_t k) const {
+    size_t large = k / nbit;
+    size_t small = k % nbit;
+    return raw[large] >> small & 1;
+  }
+};
+
+std::mt19937_64 rsk(0315);
+char const* only = nullptr;
+size_t volatile sink;
+
+double now() {
+  using namespace std::chrono;
+  return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+template <typename Fn>
+double per_query(std::vector<size_t> const& qs, Fn fn) {
+  size_t sum = 0;
+  double start = now();
+  // each query waits for the last one, to see the latency
+  for (auto q: qs) sum += fn(q ^ (sum >> 63));
+  double elapsed = now() - start;
+  sink = sum;
+  return elapsed / qs.size() * 1e9;
+}
+
+template <typename BitVector>
+void bench(char const* name, std::vector<bool> const& vb, size_t ones) {
+  if (only && strcmp(name, only) != 0) return;
+  size_t n = vb.size();
+  size_t zeros = n - ones;
+  BitVector b(vb);
+
+  size_t q = 10000000;
+  std::vector<size_t> rq(q), s1q(q), s0q(q);
+  for (auto& x: rq) x = rsk() % (n+1);
+  for (auto& x: s1q) x = rsk() % ones + 1;
+  for (auto& x: s0q) x = rsk() % zeros + 1;
+
+  fprintf(stderr, "  %-4s  rank1 %7.2f  select1 %7.2f  select0 %7.2f  ns/query\n", name,
+          per_query(rq, [&](size_t k) { return b.rank1(k); }),
+          per_query(s1q, [&](size_t k) { return b.select1(k); }),
+          per_query(s0q, [&](size_t k) { return b.select0(k); }));
+}
+
+template <typename BitVector>
+void bench_wm(char const* name, std::vector<uint32_t> const& a) {
+  if (only && strcmp(name, only) != 0) return;
+  size_t n = a.size();
+  wavelet_matrix<uint32_t, 32, BitVector> wm(a.begin(), a.end());
+
+  size_t q = 1000000;
+  std::vector<size_t> qs(q);
+  for (auto& x: qs) x = rsk();
+  fprintf(stderr, "  %-4s  quantile %7.2f ns/query\n", name, per_query(qs, [&](size_t x) {
+    size_t s = x % n, t = (x >> 32) % n;
+    if (s > t) std::swap(s, t);
+    return wm.quantile((t-s) / 2, s, t+1);
+  }));
+}
+
+void verify(size_t n) {
+  for (size_t per_mille: {0, 1, 100, 500, 999, 1000}) {
+    std::vector<bool> vb(n);
+    for (size_t i = 0; i < n; ++i) vb[i] = (rsk() % 1000 < per_mille);
+    old_bit_vector expected(vb);
+    bit_vector b(vb);
+    assert(b.size() == n);
+    for (size_t i = 0; i <= n; ++i) assert(b.rank1(i) == expected.rank1(i));
+    for (size_t i = 0; i < n; ++i) assert(b[i] == vb[i]);
+    for (size_t k = 0; k <= n+1; ++k) {
+      assert(b.select1(k) == expected.select1(k));
+      assert(b.select0(k) == expected.select0(k));
+    }
+  }
+}
+
+int main(int argc, char* argv[]) {
+  size_t n = (argc > 1)? strtoull(argv[1], nullptr, 10): size_t(1) << 28;
+  if (argc > 2) only = argv[2];
+
+  for (size_t m: {0, 1, 447, 448, 449, 10000, 100000}) verify(m);
+
+  for (size_t per_mille: {500, 100, 1}) {
+    std::vector<bool> vb(n);
+    size_t ones = 0;
+    for (size_t i = 0; i < n; ++i) ones += (vb[i] = (rsk() % 1000 < per_mille));
+    fprintf(stderr, "n = %zu, %.1f%% ones\n", n, per_mille / 10.0);
+    bench<old_bit_vector>("old", vb, ones);
+    bench<bit_vector>("new", vb, ones);
+  }
+
+  {
+    std::vector<uint32_t> a(n / 64);
+    for (auto& x: a) x = rsk();
+    fprintf(stderr, "wavelet_matrix, n = %zu\n", a.size());
+    bench_wm<old_bit_vector>("old", a);
+    bench_wm<bit_vector>("new", a);
+  }
+}
@@ -0,0 +1,34 @@
+// Counts the heap in use by replacing the global operator new and
+// operator delete, for the benches.  heap_cur is the bytes allocated now
+// (as malloc_usable_size() sees them), heap_peak the most of it so far,
+// and heap_count the number of allocations; a bench resets the latter
+// two as it likes.
+
+size_t heap_cur = 0, heap_peak = 0, heap_count = 0;
+
+void* heap_count_alloc(void* p) {
+  if (!p) throw std::bad_alloc();
+  heap_cur += malloc_usable_size(p);
+  heap_peak = std::max(heap_peak, heap_cur);
+  ++heap_count;
+  return p;
+}
+
+// Not inlined, so that GCC does not see free() of what operator new
+// returned (-Wmismatched-new-delete).
+__attribute__((noinline)) void heap_count_free(void* p) {
+  if (p) heap_cur -= malloc_usable_size(p);
+  free(p);
+}
+
+void* operator new(size_t size) { return heap_count_alloc(malloc(size)); }
+void* operator new(size_t size, std::align_val_t al) {
+  // for the blocks of bit_vector
+  size_t align = static_cast<size_t>(al);
+  return heap_count_alloc(aligned_alloc(align, (size + align-1) / align * align));
+}
+
+void operator delete(void* p) noexcept { heap_count_free(p); }
+void operator delete(void* p, size_t) noexcept { heap_count_free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { heap_count_free(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { heap_count_free(p); }
@@ -0,0 +1,93 @@
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <cassert>
+#include <chrono>
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <new>
+#include <queue>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <malloc.h>
+
+#include "../../algorithm/bucket_sort.cpp"
+#include "../heap_usage.cpp"
+
+// usage: ./bucket_sort [n [max_hash]]
+// Sorts n (default: 10^7) pairs by their first (< max_hash, default
+// 1000), and prints the throughput and the peak heap usage of each
+// method besides the input itself.
+
+template <typename ForwardIt, typename Hash = std::hash<typename ForwardIt::value_type>>
+void old_bucket_sort(ForwardIt first, ForwardIt last, Hash hf = Hash()) {
+  // the version with one std::queue per bucket, kept for comparison
+  using value_type = typename ForwardIt::value_type;
+  size_t size = 0;
+  for (auto it = first; it != last; ++it)
+    size = std::max(size, hf(*it)+1);
+
+  std::vector<std::queue<value_type>> bucket(size);
+  for (auto it = first; it != last; ++it) {
+    size_t i = hf(*it);
+    bucket[i].push(std::move(*it));
+  }
+
+  for (size_t i = 0; i < size; ++i)
+    while (!bucket[i].empty()) {
+      *first++ = std::move(bucket[i].front());
+      bucket[i].pop();
+    }
+}
+
+double now() {
+  using namespace std::chrono;
+  return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+using elem = std::pair<uint32_t, uint32_t>;
+struct first_hash {
+  size_t operator ()(elem const& x) const { return x.first; }
+};
+
+template <typename Fn>
+void bench(char const* name, std::vector<elem> const& a, std::vector<elem> const& expected, Fn fn) {
+  std::vector<elem> b = a;
+  size_t base = heap_cur;
+  heap_peak = heap_cur;
+  heap_count = 0;
+  double start = now();
+  fn(b);
+  double elapsed = now() - start;
+  if (!expected.empty()) assert(b == expected);
+  else assert(std::is_sorted(b.begin(), b.end(), [](auto& x, auto& y) { return x.first < y.first; }));
+  fprintf(stderr, "%-20s %8.2f M elem/s  %10.2f MiB peak  %9zu allocations\n",
+          name, a.size() / elapsed * 1e-6, (heap_peak - base) / 1048576.0, heap_count);
+}
+
+int main(int argc, char* argv[]) {
+  size_t n = (argc > 1)? strtoull(argv[1], nullptr, 10): 10000000;
+  uint32_t max_hash = (argc > 2)? strtoul(argv[2], nullptr, 10): 1000;
+
+  std::mt19937 rsk(0315);
+  std::vector<elem> a(n);
+  for (size_t i = 0; i < n; ++i) a[i] = {rsk() % max_hash, i};
+  fprintf(stderr, "n = %zu, max_hash = %u, input %.2f MiB\n",
+          n, max_hash, n * sizeof(elem) / 1048576.0);
+
+  std::vector<elem> expected = a;
+  std::stable_sort(expected.begin(), expected.end(), [](auto& x, auto& y) { return x.first < y.first; });
+
+  bench("old_bucket_sort", a, expected, [](auto& b) {
+    old_bucket_sort(b.begin(), b.end(), first_hash());
+  });
+  bench("bucket_sort", a, expected, [](auto& b) {
+    bucket_sort(b.begin(), b.end(), first_hash());
+  });
+  bench("inplace_bucket_sort", a, {}, [](auto& b) {
+    inplace_bucket_sort(b.begin(), b.end(), first_hash());
+  });
+}
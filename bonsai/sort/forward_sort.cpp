@@ -0,0 +1,131 @@
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <cassert>
+#include <chrono>
+#include <algorithm>
+#include <forward_list>
+#include <functional>
+#include <iterator>
+#include <list>
+#include <random>
+#include <utility>
+#include <vector>
+
+#define main stl_like_list_demo
+#include "../../STL-like/list.cpp"
+#undef main
+#include "../../algorithm/forward_sort.cpp"
+
+// usage: ./forward_sort [n [method]]
+// Sorts n (default: 10^6) ints in lists, random and nearly sorted, by
+// std::list::sort and forward_sort, and prints ns/element.  Nodes freed
+// by one method are reused by the next in a scattered order, which
+// slows down the later ones; give a method to run it alone.
+
+template <typename ForwardIt>
+void old_forward_merge(ForwardIt first, ForwardIt mid, ForwardIt last) {
+  using value_type = typename std::iterator_traits<ForwardIt>::value_type;
+  std::vector<value_type> left(std::make_move_iterator(first), std::make_move_iterator(mid));
+  std::vector<value_type> right(std::make_move_iterator(mid), std::make_move_iterator(last));
+  auto itl = left.begin();
+  auto itr = right.begin();
+  while (first != last) {
+    bool from_left = !(itl == left.end() || (itr != right.end() && *itr < *itl));
+    *first++ = std::move(*(from_left? itl: itr));
+    ++(from_left? itl: itr);
+  }
+}
+
+template <typename ForwardIt>
+void old_forward_sort(ForwardIt first, ForwardIt last) {
+  // the previous version, with my_merge read as old_forward_merge
+  if (first == last) return;
+
+  using difference_type = typename std::iterator_traits<ForwardIt>::difference_type;
+  auto next_until = [](ForwardIt it, difference_type n, ForwardIt sent) {
+    while (n-- && it != sent) ++it;
+    return it;
+  };
+  for (difference_type width = 1; true; width <<= 1) {
+    auto first0 = first;
+    while (first0 != last) {
+      auto mid0 = next_until(first0, width, last);
+      auto last0 = next_until(mid0, width, last);
+      if (mid0 == last0) {
+        if (first == first0) return;
+        break;
+      }
+      old_forward_merge(first0, mid0, last0);
+      first0 = last0;
+    }
+  }
+}
+
+std::mt19937 rsk(0315);
+char const* only = nullptr;
+
+double now() {
+  using namespace std::chrono;
+  return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+template <typename Container, typename Fn>
+void bench(char const* name, std::vector<int> const& a, std::vector<int> const& expected, Fn fn) {
+  if (only && strcmp(name, only) != 0) return;
+  Container c;
+  for (int x: a) c.push_back(x);
+  double start = now();
+  fn(c);
+  double elapsed = now() - start;
+  assert(std::equal(c.begin(), c.end(), expected.begin(), expected.end()));
+  fprintf(stderr, "  %-14s %8.2f ns/elem\n", name, elapsed / a.size() * 1e9);
+}
+
+template <typename Tp>
+struct forward_list_adaptor: std::forward_list<Tp> {
+  // push_back() for bench(), in O(1) by keeping the last node
+  typename std::forward_list<Tp>::iterator back = this->before_begin();
+  void push_back(Tp const& x) { back = this->insert_after(back, x); }
+};
+
+void bench_all(char const* kind, std::vector<int> const& a) {
+  fprintf(stderr, "%s, n = %zu\n", kind, a.size());
+  std::vector<int> expected = a;
+  std::sort(expected.begin(), expected.end());
+  bench<std::list<int>>("list::sort", a, expected, [](auto& c) { c.sort(); });
+  bench<std::list<int>>("old", a, expected, [](auto& c) {
+    old_forward_sort(c.begin(), c.end());
+  });
+  bench<std::list<int>>("list", a, expected, [](auto& c) {
+    forward_sort(c.begin(), c.end());
+  });
+  bench<forward_list_adaptor<int>>("forward_list", a, expected, [](auto& c) {
+    forward_sort(c.begin(), c.end());
+  });
+  bench<stl_like::list<int>>("stl_like", a, expected, [](auto& c) {
+    forward_sort(c.begin(), c.end());
+  });
+}
+
+int main(int argc, char* argv[]) {
+  size_t n = (argc > 1)? strtoull(argv[1], nullptr, 10): 1000000;
+  if (argc > 2) only = argv[2];
+  {
+    std::vector<int> a(n);
+    for (auto& ai: a) ai = rsk();
+    bench_all("random", a);
+  }
+  {
+    std::vector<int> a(n);
+    for (size_t i = 0; i < n; ++i) a[i] = i;
+    for (size_t i = 0; i < n / 100; ++i) std::swap(a[rsk() % n], a[rsk() % n]);
+    bench_all("sorted, 1% swapped", a);
+  }
+  {
+    std::vector<int> a(n);
+    for (size_t i = 0; i < n; ++i) a[i] = i % 1000;
+    bench_all("1000 sorted runs", a);
+  }
+}
@@ -0,0 +1,74 @@
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <cassert>
+#include <climits>
+#include <chrono>
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <limits>
+#include <random>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../../algorithm/radix_sort.cpp"
+
+// usage: ./parallel_radix_sort [n [max_threads]]
+// Sorts n (default: 10^8) random keys and pair<key, value>s with 1, 2,
+// 4, ..., max_threads (default: hardware_concurrency) threads, and
+// prints the time and the speedup over radix_sort().
+
+std::mt19937_64 rsk(0315);
+
+double now() {
+  using namespace std::chrono;
+  return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+template <typename Tp>
+void scaling(char const* kind, std::vector<Tp> const& a, size_t max_threads) {
+  fprintf(stderr, "%s, n = %zu\n", kind, a.size());
+  std::vector<Tp> expected = a;
+  double start = now();
+  radix_sort(expected.begin(), expected.end());
+  double base = now() - start;
+  fprintf(stderr, "  radix_sort     %8.3f s\n", base);
+
+  for (size_t k = 1; k <= max_threads; k = (k < max_threads && 2*k > max_threads)? max_threads: 2*k) {
+    std::vector<Tp> b = a;
+    double start = now();
+    parallel_radix_sort(b.begin(), b.end(), k);
+    double elapsed = now() - start;
+    assert(b == expected);
+    fprintf(stderr, "  %2zu thread(s)   %8.3f s  x%.2f\n", k, elapsed, base / elapsed);
+    if (k == max_threads) break;
+  }
+}
+
+int main(int argc, char* argv[]) {
+  size_t n = (argc > 1)? strtoull(argv[1], nullptr, 10): 100000000;
+  size_t max_threads = (argc > 2)? strtoull(argv[2], nullptr, 10): 0;
+  if (max_threads == 0) max_threads = std::max(1u, std::thread::hardware_concurrency());
+
+  {
+    std::vector<uint64_t> a(n);
+    for (auto& ai: a) ai = rsk();
+    scaling("uint64", a, max_threads);
+  }
+  {
+    std::vector<int32_t> a(n);
+    for (auto& ai: a) ai = int32_t(rsk()) >> (rsk() % 32);
+    scaling("int32, mixed sign", a, max_threads);
+  }
+  {
+    // small keys, so that equal keys must keep their order
+    std::vector<std::pair<int64_t, uint32_t>> a(n);
+    for (size_t i = 0; i < n; ++i) a[i] = {int64_t(rsk() % 100000) - 50000, i};
+    scaling("pair<int64, uint32>", a, max_threads);
+  }
+}
@@ -0,0 +1,128 @@
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <cassert>
+#include <climits>
+#include <chrono>
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <limits>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../../algorithm/radix_sort.cpp"
+
+// usage: ./radix_sort [n...]
+// For each n (default: 10^6 10^7 10^8), sorts n random keys of a few
+// kinds and prints ns/key for std::sort, the previous radix_sort, and
+// radix_sort with 8-, 11- and 16-bit digits.
+
+template <class BidirIt>
+void old_radix_sort(BidirIt first, BidirIt last) {
+  // the version before one-pass histograms, kept for comparison
+  using value_type = typename BidirIt::value_type;
+  constexpr int shift = 8;
+  constexpr int max_exp = sizeof(value_type);
+  constexpr size_t size = 1 << shift;
+  constexpr size_t mask = size-1;
+  std::vector<value_type> work(std::distance(first, last));
+  for (int i = 0, cs = 0; i < max_exp; ++i) {
+    size_t num[size] = {};
+
+    for (BidirIt it = first; it != last; ++it)
+      ++num[*it >> cs & mask];
+    {
+      size_t tmp = 0;
+      for (size_t j = 0; j < size; ++j)
+        std::swap(tmp, num[j] += tmp);
+    }
+    for (BidirIt it = first; it != last; ++it)
+      work[num[*it >> cs & mask]++] = *it;
+    {
+      size_t j = 0;
+      for (BidirIt it = first; it != last; ++it)
+        *it = work[j++];
+    }
+    cs += shift;
+  }
+  if (!std::is_signed<value_type>::value) return;
+
+  BidirIt mid = last;
+  for (BidirIt it = last; it-- != first;)
+    if (*it >= 0) {
+      mid = ++it;
+      break;
+    }
+
+  if (mid == last) return;
+  ptrdiff_t len = std::distance(mid, last);
+  std::copy(first, mid, std::next(work.begin(), len));
+  std::copy(mid, last, work.begin());
+  std::copy(work.begin(), work.end(), first);
+}
+
+std::mt19937_64 rsk(0315);
+
+double now() {
+  using namespace std::chrono;
+  return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+template <typename Tp, typename Fn>
+void bench(char const* name, std::vector<Tp> const& a, std::vector<Tp> const& expected, Fn fn) {
+  std::vector<Tp> b = a;
+  double start = now();
+  fn(b);
+  double elapsed = now() - start;
+  assert(b == expected);
+  fprintf(stderr, "  %-12s %8.2f ns/key\n", name, elapsed / a.size() * 1e9);
+}
+
+template <typename Tp>
+void bench_all(char const* kind, std::vector<Tp> const& a) {
+  fprintf(stderr, "%s, n = %zu\n", kind, a.size());
+  std::vector<Tp> expected = a;
+  std::sort(expected.begin(), expected.end());
+  bench("std::sort", a, expected, [](auto& b) { std::sort(b.begin(), b.end()); });
+  bench("old", a, expected, [](auto& b) { old_radix_sort(b.begin(), b.end()); });
+  bench("8-bit", a, expected, [](auto& b) { radix_sort<8>(b.begin(), b.end()); });
+  bench("11-bit", a, expected, [](auto& b) { radix_sort<11>(b.begin(), b.end()); });
+  bench("16-bit", a, expected, [](auto& b) { radix_sort<16>(b.begin(), b.end()); });
+}
+
+int main(int argc, char* argv[]) {
+  std::vector<size_t> ns;
+  for (int i = 1; i < argc; ++i) ns.push_back(strtoull(argv[i], nullptr, 10));
+  if (ns.empty()) ns = {1000000, 10000000, 100000000};
+
+  for (size_t n: ns) {
+    {
+      std::vector<uint64_t> a(n);
+      for (auto& ai: a) ai = rsk();
+      bench_all("uint64, full range", a);
+    }
+    {
+      // the upper passes are all skipped
+      std::vector<uint64_t> a(n);
+      for (auto& ai: a) ai = rsk() % 1000000;
+      bench_all("uint64, < 10^6", a);
+    }
+    {
+      std::vector<int64_t> a(n);
+      for (auto& ai: a) ai = int64_t(rsk()) >> (rsk() % 64);
+      bench_all("int64, mixed sign", a);
+    }
+    {
+      std::vector<int32_t> a(n);
+      for (auto& ai: a) ai = rsk();
+      bench_all("int32, full range", a);
+    }
+  }
+}
@@ -0,0 +1,129 @@
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <cassert>
+#include <climits>
+#include <chrono>
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../../algorithm/radix_sort.cpp"
+
+// usage: ./radix_sort_by [n]
+// Sorts n (default: 10^7) records, indices, doubles and short strings
+// by radix_sort_by() and by std::sort with a comparator.
+
+std::mt19937_64 rsk(0315);
+
+double now() {
+  using namespace std::chrono;
+  return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+struct record {
+  int64_t id;
+  double score;
+  int32_t age;
+  char name[12];
+};
+
+template <typename Tp, typename Sort, typename Check>
+void bench(char const* name, std::vector<Tp> const& a, Sort sort, Check check) {
+  std::vector<Tp> b = a;
+  double start = now();
+  sort(b);
+  double elapsed = now() - start;
+  check(b);
+  fprintf(stderr, "  %-14s %8.2f ns/elem\n", name, elapsed / a.size() * 1e9);
+}
+
+int main(int argc, char* argv[]) {
+  size_t n = (argc > 1)? strtoull(argv[1], nullptr, 10): 10000000;
+
+  {
+    fprintf(stderr, "record by int32 field, n = %zu\n", n);
+    std::vector<record> a(n);
+    for (auto& ai: a) ai.age = rsk() % 100000 - 50000;
+    auto age = [](record const& x) { return x.age; };
+    auto check = [&](auto const& b) {
+      for (size_t i = 1; i < n; ++i) assert(b[i-1].age <= b[i].age);
+    };
+    bench("std::sort", a, [&](auto& b) {
+      std::sort(b.begin(), b.end(), [&](auto const& x, auto const& y) { return age(x) < age(y); });
+    }, check);
+    bench("radix_sort_by", a, [&](auto& b) { radix_sort_by(b.begin(), b.end(), age); }, check);
+  }
+
+  {
+    fprintf(stderr, "indices by uint64 keys, n = %zu\n", n);
+    std::vector<uint64_t> key(n);
+    for (auto& k: key) k = rsk();
+    std::vector<uint32_t> a(n);
+    std::iota(a.begin(), a.end(), 0);
+    auto check = [&](auto const& b) {
+      for (size_t i = 1; i < n; ++i) assert(key[b[i-1]] <= key[b[i]]);
+    };
+    bench("std::sort", a, [&](auto& b) {
+      std::sort(b.begin(), b.end(), [&](uint32_t i, uint32_t j) { return key[i] < key[j]; });
+    }, check);
+    bench("radix_sort_by", a, [&](auto& b) {
+      radix_sort_by<11>(b.begin(), b.end(), [&](uint32_t i) { return key[i]; });
+    }, check);
+  }
+
+  {
+    fprintf(stderr, "double, n = %zu\n", n);
+    std::vector<double> a(n);
+    std::normal_distribution<double> nd(0.0, 1e6);
+    for (auto& ai: a) ai = nd(rsk);
+    auto check = [&](auto const& b) { assert(std::is_sorted(b.begin(), b.end())); };
+    bench("std::sort", a, [](auto& b) {
+      std::sort(b.begin(), b.end(), [](double x, double y) { return x < y; });
+    }, check);
+    bench("radix_sort", a, [](auto& b) { radix_sort<11>(b.begin(), b.end()); }, check);
+  }
+
+  {
+    fprintf(stderr, "strings of 1 to 16 letters, n = %zu\n", n);
+    std::vector<std::string> a(n);
+    for (auto& ai: a) {
+      size_t len = 1 + rsk() % 16;
+      for (size_t i = 0; i < len; ++i) ai += 'a' + rsk() % 26;
+    }
+    auto check = [&](auto const& b) { assert(std::is_sorted(b.begin(), b.end())); };
+    bench("std::sort", a, [](auto& b) {
+      std::sort(b.begin(), b.end(), [](auto const& x, auto const& y) { return x < y; });
+    }, check);
+    bench("radix_sort", a, [](auto& b) { radix_sort(b.begin(), b.end()); }, check);
+  }
+
+  {
+    // the recursion must not follow the common prefixes
+    size_t m = 1000;
+    fprintf(stderr, "strings of a 20000-byte prefix and 1 to 4 letters, n = %zu\n", m);
+    std::vector<std::string> a(m, std::string(20000, 'x'));
+    for (auto& ai: a)
+      for (size_t len = 1 + rsk() % 4; len--;) ai += 'a' + rsk() % 26;
+    auto check = [&](auto const& b) { assert(std::is_sorted(b.begin(), b.end())); };
+    bench("std::sort", a, [](auto& b) { std::sort(b.begin(), b.end()); }, check);
+    bench("radix_sort", a, [](auto& b) { radix_sort(b.begin(), b.end()); }, check);
+
+    fprintf(stderr, "strings x, xx, ..., of up to 5000 bytes, shuffled\n");
+    a.assign(5000, "");
+    for (size_t i = 0; i < a.size(); ++i) a[i].assign(i+1, 'x');
+    std::shuffle(a.begin(), a.end(), rsk);
+    bench("std::sort", a, [](auto& b) { std::sort(b.begin(), b.end()); }, check);
+    bench("radix_sort", a, [](auto& b) { radix_sort(b.begin(), b.end()); }, check);
+  }
+}
@@ -1,35 +1,108 @@
 #include <cstdio>
 #include <cstdint>
-#include <vector>
+#include <cassert>
 #include <algorithm>
+#include <random>
+#include <thread>
 #include <utility>
+#include <vector>
 
+#include "../../DataStructure/segment_tree.cpp"
 #include "../../DataStructure/basic_segment_tree.cpp"
+#include "../../utility/parallel_chunks.cpp"
+
+// DataStructure/basic_segment_tree.cpp against brute force, with single
+// updates and folds, and with their batches, on one thread and on a few
+
+std::mt19937_64 rsk(0315);
+
+template <typename Chunks>
+void test_sum(size_t n, Chunks chunks) {
+  std::vector<intmax_t> a(n);
+  for (auto& x: a) x = rsk() % 100;
+  basic_segment_tree<range_sum_single_add<intmax_t>> st(a.begin(), a.end());
 
-template <typename Tp>
-struct range_sum_single_add {
-  using first_type = Tp;
-  using second_type = Tp;
-  struct binary_operation {
-    first_type identity{};
-    first_type operator ()(first_type const& x, first_type const& y) const {
-      return x + y;
+  for (size_t round = 0; round < 10 && n > 0; ++round) {
+    std::vector<std::pair<size_t, intmax_t>> xs(rsk() % (2*n) + 1);
+    for (auto& [i, x]: xs) {
+      // few distinct indices, so that some are updated more than once
+      i = rsk() % std::min<size_t>(n, round+1) * (n / (round+1));
+      x = rsk() % 100;
+      a[i] += x;
     }
-  };
-  struct external_binary_operation {
-    first_type operator ()(first_type const& x, second_type const& y) const {
-      return x + y;
+    if (round % 2 == 0) {
+      st.modify_batch(xs, chunks);
+    } else {
+      for (auto [i, x]: xs) st.modify(i, x);
     }
-  };
-};
+    for (size_t i = 0; i < n; ++i) assert(st[i] == a[i]);
+
+    std::vector<std::pair<size_t, size_t>> rs(n + 1000);
+    for (auto& [l, r]: rs) {
+      l = rsk() % (n+1);
+      r = rsk() % (n+1);
+      if (l > r) std::swap(l, r);
+    }
+    std::vector<intmax_t> sums = st.accumulate_batch(rs, chunks);
+    for (size_t j = 0; j < rs.size(); j += rs.size() / 100 + 1) {
+      auto [l, r] = rs[j];
+      intmax_t sum = 0;
+      for (size_t i = l; i < r; ++i) sum += a[i];
+      assert(sums[j] == sum);
+      assert(st.accumulate(l, r) == sum);
+    }
+
+    intmax_t bound = rsk() % (100 * n + 1);
+    size_t expected = 0;
+    for (intmax_t sum = 0; expected < n && (sum += a[expected]) <= bound;) ++expected;
+    assert(st.partition_point([&](intmax_t x) { return x <= bound; }).first == expected);
+  }
+}
+
+template <typename Chunks>
+void test_affine(size_t n, Chunks chunks) {
+  // the maps for the same index are applied in order, as they do not
+  // commute
+  using monoid = range_sum_range_affine<uint64_t>;
+  std::vector<uint64_t> a(n);
+  std::vector<monoid::first_type> init(n);
+  for (size_t i = 0; i < n; ++i) init[i] = {a[i] = rsk(), 1};
+  basic_segment_tree<monoid> st(init.begin(), init.end());
+
+  for (size_t round = 0; round < 10; ++round) {
+    std::vector<std::pair<size_t, monoid::second_type>> xs(rsk() % (2*n) + 1);
+    std::vector<std::pair<size_t, monoid::first_type>> ys(rsk() % (2*n) + 1);
+    for (auto& [i, f]: xs) {
+      i = rsk() % n;
+      f = {rsk(), rsk()};
+      a[i] = f.first*a[i] + f.second;
+    }
+    for (auto& [i, x]: ys) {
+      i = rsk() % (n / 2 + 1);
+      x = {a[i] = rsk(), 1};
+    }
+    st.modify_batch(xs, chunks);
+    st.assign_at_batch(ys, chunks);
+
+    for (size_t i = 0; i < n; ++i) assert(st[i].first == a[i]);
+    for (size_t q = 0; q < 1000; ++q) {
+      size_t l = rsk() % (n+1);
+      size_t r = rsk() % (n+1);
+      if (l > r) std::swap(l, r);
+      uint64_t sum = 0;
+      for (size_t i = l; i < r; ++i) sum += a[i];
+      assert(st.accumulate(l, r) == std::make_pair(sum, uint64_t(r-l)));
+    }
+  }
+}
 
 int main() {
-  size_t n = 8;
-  basic_segment_tree<range_sum_single_add<int>> st(n);
-  st.modify(0, 2);
-  st.modify(5, 1);
-  for (size_t i = 1; i <= n; ++i)
-    fprintf(stderr, "[0, %zu): %d\n", i, st.accumulate(0, i));
-
-  printf("%zu\n", st.bound([](int x) { return x < 3; }));
+  for (size_t n: {1, 2, 3, 7, 8, 9, 100, 1000, 100000}) {
+    test_sum(n, basic_segment_tree<range_sum_single_add<intmax_t>>::whole_chunk());
+    test_sum(n, parallel_chunks(4));
+    if (n > 1000) continue;
+    test_affine(n, basic_segment_tree<range_sum_range_affine<uint64_t>>::whole_chunk());
+    test_affine(n, parallel_chunks(4));
+  }
+  puts("OK");
 }
@@ -1,9 +1,11 @@
 #include <cstdio>
 #include <cstdint>
+#include <cassert>
 #include <algorithm>
 #include <vector>
 #include <queue>
 #include <functional>
+#include <iterator>
 #include <utility>
 
 #include "../../algorithm/bucket_sort.cpp"
@@ -13,7 +15,19 @@ int main() {
   for (size_t i = 0; i < a.size(); ++i)
     fprintf(stderr, "%d%c", a[i], i+1<a.size()? ' ': '\n');
 
+  std::vector<int> b = a;
   bucket_sort(a.begin(), a.end());
   for (size_t i = 0; i < a.size(); ++i)
     fprintf(stderr, "%d%c", a[i], i+1<a.size()? ' ': '\n');
+
+  inplace_bucket_sort(b.begin(), b.end());
+  assert(a == b);
+
+  // stable
+  std::vector<std::pair<int, int>> c;
+  for (int i = 0; i < 100; ++i) c.emplace_back(i * 37 % 10, i);
+  auto d = c;
+  bucket_sort(c.begin(), c.end(), [](auto const& x) -> size_t { return x.first; });
+  std::stable_sort(d.begin(), d.end(), [](auto const& x, auto const& y) { return x.first < y.first; });
+  assert(c == d);
 }
@@ -0,0 +1,85 @@
+#include <cstdio>
+#include <cstdint>
+#include <cassert>
+#include <algorithm>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "../../DataStructure/dynamic_bit_vector.cpp"
+
+// DataStructure/dynamic_bit_vector.cpp against std::vector<char>, with
+// enough updates to split and merge the nodes at a few levels
+
+std::mt19937_64 rsk(0315);
+
+void check(dynamic_bit_vector const& bv, std::vector<char> const& a) {
+  size_t n = a.size();
+  assert(bv.size() == n);
+  std::vector<uint64_t> words = bv.words();
+  for (size_t i = 0; i < n; ++i) assert((words[i / 64] >> (i % 64) & 1) == uint64_t(a[i]));
+  std::vector<size_t> select0(1, 0), select1(1, 0);
+  size_t ones = 0;
+  for (size_t i = 0; i < n; ++i) {
+    assert(bv[i] == a[i]);
+    assert(bv.rank1(i) == ones);
+    assert(bv.rank0(i) == i - ones);
+    if (a[i]) {
+      ++ones;
+      select1.push_back(i+1);
+    } else {
+      select0.push_back(i+1);
+    }
+  }
+  assert(bv.rank1(n) == ones);
+  for (size_t k = 0; k < select1.size(); ++k) assert(bv.select1(k) == select1[k]);
+  for (size_t k = 0; k < select0.size(); ++k) assert(bv.select0(k) == select0[k]);
+  assert(bv.select1(select1.size()) == size_t(-1));
+  assert(bv.select0(select0.size()) == size_t(-1));
+}
+
+void random_test(size_t n, size_t ops, size_t density) {
+  std::vector<char> a(n);
+  for (size_t i = 0; i < n; ++i) a[i] = (rsk() % density == 0);
+  dynamic_bit_vector bv(std::vector<bool>(a.begin(), a.end()));
+  check(bv, a);
+
+  for (size_t q = 0; q < ops; ++q) {
+    // inserts more often in the first half, and erases in the second,
+    // to grow and shrink the tree
+    bool grow = (q < ops / 2);
+    if (a.empty() || rsk() % 4 < (grow? 3u: 1u)) {
+      size_t t = rsk() % (a.size() + 1);
+      bool x = (rsk() % density == 0);
+      bv.insert(t, x);
+      a.insert(a.begin() + t, x);
+    } else {
+      size_t t = rsk() % a.size();
+      bv.erase(t);
+      a.erase(a.begin() + t);
+    }
+    if (q % (ops / 8 + 1) == 0) check(bv, a);
+  }
+  check(bv, a);
+
+  while (!a.empty()) {
+    size_t t = rsk() % a.size();
+    bv.erase(t);
+    a.erase(a.begin() + t);
+    if (a.size() % 4096 == 0) check(bv, a);
+  }
+  check(bv, a);
+  bv.insert(0, 1);
+  a.insert(a.begin(), 1);
+  check(bv, a);
+}
+
+int main() {
+  random_test(0, 3000, 2);
+  random_test(1, 3000, 3);
+  random_test(1000, 20000, 2);
+  random_test(100000, 200000, 2);
+  random_test(100000, 100000, 50);
+  random_test(300000, 20000, 1);
+  puts("OK");
+}
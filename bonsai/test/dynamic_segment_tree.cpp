@@ -0,0 +1,118 @@
+#include <cstdio>
+#include <cstdint>
+#include <cassert>
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "../../DataStructure/segment_tree.cpp"
+#include "../../DataStructure/node_arena.cpp"
+#include "../../DataStructure/dynamic_segment_tree.cpp"
+
+// DataStructure/dynamic_segment_tree.cpp against segment_tree, on small
+// domains with range_sum_range_affine, and on the compressed coordinates
+// of [0, 2^62)
+
+std::mt19937_64 rsk(0315);
+
+void test_affine(size_t n) {
+  // against segment_tree, with the nodes made on demand from a uniform
+  // leaf; small coefficients for a while, so that the sums do not wrap
+  // and the prefix sums are monotone
+  using monoid = range_sum_range_affine<uint64_t>;
+  std::vector<monoid::first_type> init(n, {0, 1});
+  segment_tree<monoid> expected(init.begin(), init.end());
+  dynamic_segment_tree<monoid> st(n, {0, 1});
+  assert(st.size() == n);
+
+  for (size_t q = 0; q < 20000; ++q) {
+    size_t l = rsk() % (n+1);
+    size_t r = rsk() % (n+1);
+    if (l > r) std::swap(l, r);
+    if (q % 3 != 2) {
+      monoid::second_type f((q < 10000)? rsk() % 3: rsk(), rsk() % 4);
+      st.modify(l, r, f);
+      expected.modify(l, r, f);
+    } else {
+      assert(st.accumulate(l, r) == expected.accumulate(l, r));
+      if (l < r) assert(st[l] == expected[l]);
+    }
+
+    if (q < 10000) {
+      uint64_t bound = rsk() % (2 * q + 2);
+      auto pred = [&](auto const& x) { return x.first <= bound; };
+      assert(st.max_right(l, pred) == expected.max_right(l, pred));
+      assert(st.min_left(r, pred) == expected.min_left(r, pred));
+    }
+  }
+}
+
+void test_wide(size_t q) {
+  // the keys are compressed by their boundaries, the leaf for [c[i],
+  // c[i+1]) weighted with its length
+  using monoid = range_sum_range_add<uint64_t>;
+  size_t n = size_t(1) << 62;
+  std::vector<std::pair<size_t, size_t>> rs(q);
+  std::vector<size_t> cs = {0, n};
+  for (auto& [l, r]: rs) {
+    l = rsk() % (n+1);
+    r = (rsk() % 4 == 0)? l+1: rsk() % (n+1);
+    if (l > r) std::swap(l, r);
+    r = std::min(r, n);
+    cs.push_back(l);
+    cs.push_back(r);
+  }
+  std::sort(cs.begin(), cs.end());
+  cs.erase(std::unique(cs.begin(), cs.end()), cs.end());
+  auto index = [&](size_t x) { return std::lower_bound(cs.begin(), cs.end(), x) - cs.begin(); };
+  std::vector<std::pair<uint64_t, uint64_t>> init;
+  for (size_t i = 0; i+1 < cs.size(); ++i) init.emplace_back(0, cs[i+1] - cs[i]);
+  segment_tree<monoid> expected(init.begin(), init.end());
+  dynamic_segment_tree<monoid> st(n, {0, 1});
+
+  for (size_t j = 0; j < q; ++j) {
+    auto [l, r] = rs[j];
+    if (j % 2 == 0) {
+      uint64_t x = rsk();
+      st.modify(l, r, x);
+      expected.modify(index(l), index(r), x);
+    } else {
+      assert(st.accumulate(l, r).first == expected.accumulate(index(l), index(r)).first);
+    }
+  }
+  // at most two paths of 63 nodes and their siblings per update
+  assert(st.nodes() <= q * 4 * 63);
+
+  // copies are deep
+  auto copy = st;
+  copy.modify(0, n, 1);
+  assert(copy.accumulate(0, n).first == st.accumulate(0, n).first + n);
+}
+
+void test_points(size_t q) {
+  // only a leaf and a branch per point
+  using monoid = range_sum_range_add<uint64_t>;
+  size_t n = size_t(1) << 62;
+  dynamic_segment_tree<monoid> st(n, {0, 1});
+  std::vector<size_t> keys;
+  for (size_t j = 0; j < q; ++j) {
+    keys.push_back(rsk() % n);
+    st.modify(keys.back(), keys.back()+1, j+1);
+  }
+  assert(st.nodes() <= 2 * q);
+  for (size_t j = 0; j < q; ++j)
+    assert(st[keys[j]].first == j+1);
+  assert(st.accumulate(0, n).first == q * (q+1) / 2);
+}
+
+int main() {
+  for (size_t n: {1, 2, 7, 8, 9, 1000}) test_affine(n);
+  test_wide(100000);
+  test_points(100000);
+
+  dynamic_segment_tree<range_sum_range_add<int>> empty;
+  assert(empty.size() == 0 && empty.nodes() == 0);
+  puts("OK");
+}
@@ -0,0 +1,130 @@
+#include <cstdio>
+#include <cstdint>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <cassert>
+#include <cmath>
+#include <string>
+#include <random>
+
+#include "../../FastIO/fastio.cpp"
+
+// usage: ./fastio_double [float_stride] < /dev/null
+// With float_stride == 1, every float is checked (takes a while).
+
+std::mt19937_64 rsk(0315);
+
+double from_bits(uint64_t u) {
+  double x;
+  memcpy(&x, &u, sizeof x);
+  return x;
+}
+
+uint64_t to_bits(double x) {
+  uint64_t u;
+  memcpy(&u, &x, sizeof u);
+  return u;
+}
+
+void round_trip(double x) {
+  char buf[64];
+  char* e = fast::format_shortest(buf, buf + sizeof buf, x);
+  *e = '\n';
+  double y;
+  char* f = fast::parse_double(buf, e, y);
+  assert(f == e);
+  if (std::isnan(x)) {
+    assert(std::isnan(y));
+    return;
+  }
+  if (to_bits(x) != to_bits(y)) {
+    fprintf(stderr, "%a -> %.*s -> %a\n", x, int(e-buf), buf, y);
+    assert(false);
+  }
+
+  // no %.*g that reads back as x is shorter
+  if (!std::isfinite(x)) return;
+  char shortest[64];
+  for (int p = 1; p <= 17; ++p) {
+    snprintf(shortest, sizeof shortest, "%.*g", p, x);
+    if (strtod(shortest, nullptr) == x) break;
+  }
+  if (e-buf > ptrdiff_t(strlen(shortest))) {
+    fprintf(stderr, "%.*s, but %s\n", int(e-buf), buf, shortest);
+    assert(false);
+  }
+}
+
+void random_test() {
+  for (int i = 0; i < 300000; ++i) round_trip(from_bits(rsk()));
+
+  std::uniform_real_distribution<double> neko(-1e6, 1e6);
+  for (int i = 0; i < 300000; ++i) round_trip(neko(rsk));
+
+  double special[] = {
+    0.0, -0.0, 1.0, 0.1, 0.3, 1e23, 5e-324, 2.2250738585072014e-308,
+    1.7976931348623157e308, 9007199254740993.0, INFINITY, -INFINITY, NAN,
+  };
+  for (double x: special) round_trip(x);
+}
+
+void float_test(uint64_t stride) {
+  // every float (with the stride) as a double
+  for (uint64_t u = 0; u < (uint64_t(1) << 32); u += stride) {
+    uint32_t v = u;
+    float f;
+    memcpy(&f, &v, sizeof f);
+    round_trip(f);
+  }
+}
+
+void fixed_test() {
+  std::uniform_real_distribution<double> neko(-1e9, 1e9);
+  std::uniform_int_distribution<int> prec(0, 20);
+  for (int i = 0; i < 1000000; ++i) {
+    double x = neko(rsk) / (1 << (rsk() % 30));
+    int p = prec(rsk);
+    char buf[512], expected[512];
+    char* e = fast::format_fixed(buf, buf + sizeof buf, x, p);
+    *e = 0;
+    snprintf(expected, sizeof expected, "%.*f", p, x);
+    if (strcmp(buf, expected) != 0) {
+      fprintf(stderr, "%a (%d): %s, expected %s\n", x, p, buf, expected);
+      assert(false);
+    }
+  }
+}
+
+void printer_test() {
+  // print(x, precision) through a buffer too short for some results
+  FILE* fp = tmpfile();
+  std::string expected;
+  {
+    fast::fd_printer pr(256, false, fileno(fp));
+    char buf[1024];
+    for (int p: {0, 3, 17, 100, 300}) {
+      for (double x: {0.5, -1e20, 1.7976931348623157e308,
+                      -1.7976931348623157e308, 5e-324}) {
+        pr.print(x, p);
+        pr.print('\n');
+        snprintf(buf, sizeof buf, "%.*f\n", p, x);
+        expected += buf;
+      }
+    }
+  }
+  std::string actual(expected.size() + 1, 0);
+  rewind(fp);
+  actual.resize(fread(&actual[0], 1, actual.size(), fp));
+  fclose(fp);
+  assert(actual == expected);
+}
+
+int main(int argc, char* argv[]) {
+  uint64_t stride = (argc > 1)? strtoull(argv[1], nullptr, 10): 8191;
+  random_test();
+  float_test(stride);
+  fixed_test();
+  printer_test();
+  fprintf(stderr, "ok\n");
+}
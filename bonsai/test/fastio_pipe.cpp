@@ -0,0 +1,104 @@
+#include <cstdio>
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+#include <cstring>
+#include <csignal>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "../../FastIO/fastio.cpp"
+
+// usage: ./fastio_pipe
+// Each scanner type reads integers from stdin being a pipe, in a child
+// process exec'd with it, so that the global cin is constructed over the
+// pipe too (and left unused); nothing may be lost to it.
+
+std::mt19937_64 rsk(0315);
+
+std::vector<long long> expected;
+std::string text;
+
+template <typename Scanner>
+void test_scan() {
+  Scanner sc;
+  size_t n;
+  sc.scan(n);
+  std::vector<long long> a(n);
+  for (auto& ai: a) sc.scan(ai);
+  assert(a == expected);
+}
+
+template <typename Scanner>
+void test_scan_n() {
+  Scanner sc;
+  size_t n;
+  sc.scan(n);
+  std::vector<long long> a(n + 1);
+  assert(sc.scan_n(a.data(), n + 1) == n);
+  a.pop_back();
+  assert(a == expected);
+}
+
+bool run_child(char const* self, char const* name) {
+  // runs ./fastio_pipe name with text piped into its stdin
+  int fd[2];
+  assert(pipe(fd) == 0);
+  pid_t pid = fork();
+  assert(pid >= 0);
+  if (pid == 0) {
+    dup2(fd[0], 0);
+    close(fd[0]);
+    close(fd[1]);
+    execl(self, self, name, static_cast<char*>(nullptr));
+    _exit(127);
+  }
+  close(fd[0]);
+  for (size_t i = 0; i < text.size();) {
+    ssize_t k = write(fd[1], text.data() + i, text.size() - i);
+    if (k <= 0) break;  // the child died early
+    i += k;
+  }
+  close(fd[1]);
+  int status;
+  waitpid(pid, &status, 0);
+  return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+int main(int argc, char* argv[]) {
+  // several times buf_size, so that the refilling ones reread
+  size_t n = 300000;
+  expected.resize(n);
+  text = std::to_string(n) + "\n";
+  for (auto& x: expected) {
+    x = static_cast<long long>(rsk()) >> (rsk() % 64);
+    text += std::to_string(x);
+    text += (rsk() % 8 == 0)? '\n': ' ';
+  }
+
+  if (argc > 1) {
+    std::string name = argv[1];
+    if (name == "scanner::scan") test_scan<fast::scanner>();
+    if (name == "scanner::scan_n") test_scan_n<fast::scanner>();
+    if (name == "prefetching_scanner::scan") test_scan<fast::prefetching_scanner>();
+    if (name == "prefetching_scanner::scan_n") test_scan_n<fast::prefetching_scanner>();
+    if (name == "mapped_scanner::scan") test_scan<fast::mapped_scanner>();
+    if (name == "mapped_scanner::scan_n") test_scan_n<fast::mapped_scanner>();
+    return 0;
+  }
+
+  signal(SIGPIPE, SIG_IGN);
+  bool ok = true;
+  for (char const* name: {"scanner::scan", "scanner::scan_n",
+                          "prefetching_scanner::scan", "prefetching_scanner::scan_n",
+                          "mapped_scanner::scan", "mapped_scanner::scan_n"}) {
+    bool res = run_child("/proc/self/exe", name);
+    fprintf(stderr, "%-28s %s\n", name, res? "ok": "NG");
+    ok &= res;
+  }
+  assert(ok);
+}
@@ -0,0 +1,120 @@
+#include <cstdio>
+#include <cstdint>
+#include <cassert>
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "../../DataStructure/segment_tree.cpp"
+#include "../../DataStructure/basic_segment_tree.cpp"
+#include "../../DataStructure/node_arena.cpp"
+#include "../../DataStructure/persistent_segment_tree.cpp"
+
+// DataStructure/persistent_segment_tree.cpp against a copy of the array
+// per version, with range_sum_single_add and range_sum_range_affine,
+// before and after releasing versions and collecting; and quantile()
+// against sorting
+
+std::mt19937_64 rsk(0315);
+
+template <typename Monoid, typename Tree, typename Array>
+void check(Tree const& st, std::vector<Array> const& as, std::vector<bool> const& live) {
+  typename Monoid::binary_operation op;
+  size_t n = st.size();
+  for (size_t q = 0; q < 2000; ++q) {
+    size_t t = rsk() % as.size();
+    if (!live[t]) continue;
+    size_t l = rsk() % (n+1);
+    size_t r = rsk() % (n+1);
+    if (l > r) std::swap(l, r);
+    auto expected = op.identity;
+    for (size_t i = l; i < r; ++i) expected = op(expected, as[t][i]);
+    assert(st.accumulate(t, l, r) == expected);
+    if (l < r) assert(st.get(t, l) == as[t][l]);
+  }
+}
+
+template <typename Monoid, typename GenValue, typename GenOp>
+void random_test(size_t n, bool uniform, GenValue gen_value, GenOp gen_op) {
+  using value_type = typename Monoid::first_type;
+  typename Monoid::external_binary_operation op;
+  std::vector<std::vector<value_type>> as(1, std::vector<value_type>(n, gen_value()));
+  if (!uniform) for (auto& x: as[0]) x = gen_value();
+  auto st = uniform? persistent_segment_tree<Monoid>(n, as[0][0]):
+    persistent_segment_tree<Monoid>(as[0].begin(), as[0].end());
+  if (uniform) assert(st.nodes() <= 2 * 64);
+
+  std::vector<bool> live(1, true);
+  for (size_t j = 0; j < 3000; ++j) {
+    size_t t = rsk() % as.size();
+    if (!live[t]) continue;
+    size_t i = rsk() % n;
+    auto a = as[t];
+    size_t u;
+    if (rsk() % 2) {
+      auto f = gen_op();
+      a[i] = op(a[i], f);
+      u = st.modify(t, i, f);
+    } else {
+      a[i] = gen_value();
+      u = st.assign_at(t, i, a[i]);
+    }
+    assert(u == as.size());
+    as.push_back(a);
+    live.push_back(true);
+    if (j == 1000) {
+      // a version of every four remains
+      for (size_t s = 0; s < as.size(); ++s) {
+        if (s % 4 == 0) continue;
+        st.release(s);
+        live[s] = false;
+      }
+      size_t before = st.nodes();
+      check<Monoid>(st, as, live);
+      st.collect();
+      assert(st.nodes() < before);
+      check<Monoid>(st, as, live);
+    }
+  }
+  check<Monoid>(st, as, live);
+  auto copy = st;
+  copy.collect();
+  check<Monoid>(copy, as, live);
+}
+
+void test_quantile(size_t n, size_t m) {
+  // the k-th smallest of a[l..r), from the versions counting a[0..i)
+  std::vector<size_t> a(n);
+  for (auto& x: a) x = rsk() % m;
+  persistent_segment_tree<range_sum_single_add<int>> st(m);
+  for (size_t i = 0; i < n; ++i) assert(st.modify(i, a[i], 1) == i+1);
+  for (size_t q = 0; q < 3000; ++q) {
+    size_t l = rsk() % (n+1);
+    size_t r = rsk() % (n+1);
+    if (l > r) std::swap(l, r);
+    std::vector<size_t> b(a.begin()+l, a.begin()+r);
+    std::sort(b.begin(), b.end());
+    int k = rsk() % (b.size() + 1);
+    assert(st.quantile(k, l, r) == ((size_t(k) < b.size())? b[k]: m));
+  }
+}
+
+int main() {
+  for (size_t n: {1, 2, 3, 7, 8, 9, 100, 1000}) {
+    for (bool uniform: {false, true}) {
+      auto sum = [] { return intmax_t(rsk() % 100); };
+      random_test<range_sum_single_add<intmax_t>>(n, uniform, sum, sum);
+      using pair = std::pair<uint64_t, uint64_t>;
+      random_test<range_sum_range_affine<uint64_t>>(n, uniform, [] { return pair(rsk(), 1); },
+                                                     [] { return pair(rsk(), rsk()); });
+    }
+    test_quantile(n, n);
+    test_quantile(n, 5);
+  }
+
+  persistent_segment_tree<range_sum_single_add<int>> empty;
+  assert(empty.size() == 0 && empty.versions() == 1 && empty.nodes() == 0);
+  puts("OK");
+}
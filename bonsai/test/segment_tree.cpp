@@ -0,0 +1,86 @@
+#include <cstdio>
+#include <cstdint>
+#include <climits>
+#include <cassert>
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "../../DataStructure/segment_tree.cpp"
+
+// DataStructure/segment_tree.cpp against brute force, with
+// range_sum_range_add and range_sum_range_affine
+
+std::mt19937_64 rsk(0315);
+
+void test_add(size_t n) {
+  std::vector<std::pair<intmax_t, intmax_t>> init(n);
+  std::vector<intmax_t> a(n);
+  for (size_t i = 0; i < n; ++i) {
+    a[i] = rsk() % 100;
+    init[i] = {a[i], 1};
+  }
+  segment_tree<range_sum_range_add<intmax_t>> st(init.begin(), init.end());
+  assert(st.size() == n);
+
+  for (size_t q = 0; q < 20000; ++q) {
+    size_t l = rsk() % (n+1);
+    size_t r = rsk() % (n+1);
+    if (l > r) std::swap(l, r);
+    if (q % 2 == 0) {
+      intmax_t x = rsk() % 100;
+      st.modify(l, r, x);
+      for (size_t i = l; i < r; ++i) a[i] += x;
+    } else {
+      intmax_t sum = 0;
+      for (size_t i = l; i < r; ++i) sum += a[i];
+      assert(st.accumulate(l, r).first == sum);
+    }
+
+    // with nonnegative elements, prefix sums are monotone
+    intmax_t bound = rsk() % (100 * n + 1);
+    auto pred = [&](auto const& x) { return x.first <= bound; };
+    size_t expected_r = l;
+    for (intmax_t sum = 0; expected_r < n && (sum += a[expected_r]) <= bound;) ++expected_r;
+    assert(st.max_right(l, pred) == expected_r);
+    size_t expected_l = r;
+    for (intmax_t sum = 0; expected_l > 0 && (sum += a[expected_l-1]) <= bound;) --expected_l;
+    assert(st.min_left(r, pred) == expected_l);
+  }
+  for (size_t i = 0; i < n; ++i) assert(st[i].first == a[i]);
+}
+
+void test_affine(size_t n) {
+  using monoid = range_sum_range_affine<uint64_t>;
+  std::vector<uint64_t> a(n);
+  std::vector<std::pair<uint64_t, uint64_t>> init(n);
+  for (size_t i = 0; i < n; ++i) init[i] = {a[i] = rsk(), 1};
+  segment_tree<monoid> st(init.begin(), init.end());
+
+  for (size_t q = 0; q < 20000; ++q) {
+    size_t l = rsk() % (n+1);
+    size_t r = rsk() % (n+1);
+    if (l > r) std::swap(l, r);
+    if (q % 3 != 2) {
+      uint64_t b = rsk();
+      uint64_t c = rsk();
+      st.modify(l, r, {b, c});
+      for (size_t i = l; i < r; ++i) a[i] = b*a[i] + c;
+    } else {
+      uint64_t sum = 0;
+      for (size_t i = l; i < r; ++i) sum += a[i];
+      assert(st.accumulate(l, r).first == sum);
+      if (l < r) assert(st[l].first == a[l]);
+    }
+  }
+}
+
+int main() {
+  for (size_t n: {1, 2, 3, 7, 8, 9, 100, 1000}) {
+    test_add(n);
+    test_affine(n);
+  }
+  puts("OK");
+}
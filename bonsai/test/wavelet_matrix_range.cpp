@@ -0,0 +1,82 @@
+#include <cstdio>
+#include <cstdint>
+#include <cassert>
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <map>
+#include <random>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../../DataStructure/wavelet_matrix.cpp"
+
+// range_freq, range_list, topk_frequent and range_sum of
+// DataStructure/wavelet_matrix.cpp, against brute force
+
+std::mt19937_64 rsk(0315);
+
+template <typename Tp, size_t bitlen>
+void random_test(size_t n, Tp max) {
+  std::vector<Tp> a(n);
+  for (auto& x: a) x = rsk() % max;
+  if (n > 0) a[rsk() % n] = max;
+  wavelet_matrix<Tp, bitlen> wm(a.begin(), a.end(), false);
+  wm.build_sums();
+
+  for (size_t q = 0; q < 300; ++q) {
+    size_t s = rsk() % (n+1);
+    size_t t = rsk() % (n+1);
+    if (s > t) std::swap(s, t);
+    Tp lo = rsk() % max;
+    Tp hi = (q % 10 == 0)? std::numeric_limits<Tp>::max(): Tp(rsk() % max);
+    if (q % 7 == 0) hi = lo;
+
+    std::map<Tp, size_t> freq;
+    for (size_t i = s; i < t; ++i)
+      if (lo <= a[i] && a[i] <= hi) ++freq[a[i]];
+    size_t count = 0;
+    uint64_t sum = 0;
+    for (auto [x, c]: freq) {
+      count += c;
+      sum += uint64_t(x) * c;
+    }
+
+    assert(wm.range_freq(s, t, lo, hi) == count);
+    assert(wm.range_sum(s, t, lo, hi) == sum);
+    std::vector<std::pair<Tp, size_t>> listed;
+    wm.range_list(s, t, lo, hi, [&](Tp x, size_t c) { listed.emplace_back(x, c); });
+    assert((listed == std::vector<std::pair<Tp, size_t>>(freq.begin(), freq.end())));
+
+    std::map<Tp, size_t> all;
+    for (size_t i = s; i < t; ++i) ++all[a[i]];
+    std::vector<std::pair<Tp, size_t>> expected(all.begin(), all.end());
+    std::stable_sort(expected.begin(), expected.end(), [](auto const& x, auto const& y) {
+      return x.second > y.second;
+    });
+    size_t k = rsk() % 8;
+    if (expected.size() > k) expected.resize(k);
+    assert(wm.topk_frequent(s, t, k) == expected);
+  }
+}
+
+int main() {
+  for (size_t n: {0, 1, 2, 10, 100, 1000}) {
+    random_test<uint32_t, 4>(n, 15);
+    random_test<uint32_t, 10>(n, 1000);
+    random_test<uint8_t, 8>(n, 255);
+    random_test<uint32_t, 32>(n, uint32_t(-1));
+    random_test<uint64_t, 64>(n, 1 << 20);
+  }
+
+  std::vector<uint32_t> a{3, 1, 4, 1, 5, 9, 2, 6, 5, 3, 5};
+  wavelet_matrix<uint32_t, 4> wm(a.begin(), a.end());
+  wm.build_sums();
+  for (auto [x, c]: wm.topk_frequent(0, a.size(), 3))
+    fprintf(stderr, "%u: %zu\n", x, c);
+  fprintf(stderr, "[2, 9] in [1, 8): %zu values, sum %ju\n",
+          wm.range_freq(1, 8, 2, 9), uintmax_t(wm.range_sum(1, 8, 2, 9)));
+}
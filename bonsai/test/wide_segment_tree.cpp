@@ -0,0 +1,72 @@
+#include <cstdio>
+#include <cstdint>
+#include <cassert>
+#include <algorithm>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "../../DataStructure/segment_tree.cpp"
+#include "../../DataStructure/basic_segment_tree.cpp"
+#include "../../DataStructure/wide_segment_tree.cpp"
+
+// DataStructure/wide_segment_tree.cpp against basic_segment_tree, with
+// range_sum_single_add and range_sum_range_affine, for several fanouts
+
+std::mt19937_64 rsk(0315);
+
+template <typename Monoid, size_t Fanout, typename GenValue, typename GenOp>
+void random_test(size_t n, GenValue gen_value, GenOp gen_op) {
+  std::vector<typename Monoid::first_type> a(n);
+  for (auto& x: a) x = gen_value();
+  basic_segment_tree<Monoid> expected(a.begin(), a.end());
+  wide_segment_tree<Monoid, Fanout> st(a.begin(), a.end());
+  assert(st.size() == n);
+
+  for (size_t q = 0; q < 3000; ++q) {
+    size_t l = rsk() % (n+1);
+    size_t r = rsk() % (n+1);
+    if (l > r) std::swap(l, r);
+    assert(st.accumulate(l, r) == expected.accumulate(l, r));
+    if (n > 0 && q % 3 == 0) {
+      size_t i = rsk() % n;
+      if (q % 2) {
+        auto f = gen_op();
+        st.modify(i, f);
+        expected.modify(i, f);
+      } else {
+        auto x = gen_value();
+        st.assign_at(i, x);
+        expected.assign_at(i, x);
+      }
+      assert(st[i] == expected[i]);
+    }
+  }
+}
+
+void partition_point_test(size_t n) {
+  using monoid = range_sum_single_add<uint64_t>;
+  std::vector<uint64_t> a(n);
+  for (auto& x: a) x = rsk() % 4;
+  basic_segment_tree<monoid> expected(a.begin(), a.end());
+  wide_segment_tree<monoid> st(a.begin(), a.end());
+  for (uint64_t bound = 0; bound <= 3 * n + 1; bound += std::max<size_t>(1, n / 50)) {
+    auto pred = [bound](uint64_t x) { return x <= bound; };
+    assert(st.partition_point(pred) == expected.partition_point(pred));
+  }
+}
+
+int main() {
+  auto sum = [] { return rsk() % 1000; };
+  auto leaf = [] { return std::make_pair<uint64_t, uint64_t>(rsk(), 1); };
+  auto affine = [] { return std::make_pair<uint64_t, uint64_t>(rsk(), rsk()); };
+  for (size_t n: {0, 1, 2, 3, 4, 5, 8, 9, 16, 17, 63, 64, 65, 1000, 4096, 5000}) {
+    random_test<range_sum_single_add<uint64_t>, 8>(n, sum, sum);
+    random_test<range_sum_single_add<uint64_t>, 2>(n, sum, sum);
+    random_test<range_sum_single_add<uint64_t>, 3>(n, sum, sum);
+    random_test<range_sum_range_affine<uint64_t>, 4>(n, leaf, affine);
+    random_test<range_sum_range_affine<uint64_t>, 5>(n, leaf, affine);
+    partition_point_test(n);
+  }
+  puts("OK");
+}
@@ -0,0 +1,27 @@
+class parallel_chunks {
+  // A splitter for the batch operations of basic_segment_tree, taking
+  // them to threads: chunks(lo, hi, fn) calls fn(a, b) on consecutive
+  // chunks of [lo, hi), each on its own thread, with as many of them as
+  // leave each at least S_min items.  The bounds between chunks are
+  // multiples of 128, so that the parents of the nodes of different
+  // chunks are in distinct words of a bitmap.
+  static constexpr size_t S_min = 1 << 14;
+  size_t M_threads;
+
+public:
+  explicit parallel_chunks(size_t threads = std::thread::hardware_concurrency()):
+    M_threads(std::max<size_t>(1, threads)) {}
+
+  template <typename Fn>
+  void operator ()(size_t lo, size_t hi, Fn fn) const {
+    size_t threads = std::max<size_t>(1, std::min(M_threads, (hi - lo) / S_min));
+    if (threads == 1) return fn(lo, hi);
+    std::vector<size_t> bs(threads+1, hi);
+    bs[0] = lo;
+    for (size_t k = 1; k < threads; ++k)
+      bs[k] = (lo + (hi - lo) * k / threads) & ~size_t(127);
+    std::vector<std::thread> ths;
+    for (size_t k = 0; k < threads; ++k) ths.emplace_back(fn, bs[k], bs[k+1]);
+    for (auto& th: ths) th.join();
+  }
+};